@@ -0,0 +1,341 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "ray_tracing.h"
+#include "camera.h"
+#include <vector>
+
+// Define RT_BENCH_MESHES after generating the benchmark meshes with
+//   python3 tools/obj2mesh.py --sphere 1000 --sphere 10000 --sphere 100000 --header include/bench_meshes.h
+#ifdef RT_BENCH_MESHES
+#include "bench_meshes.h"
+#endif
+
+// Benchmarks
+//
+// Built with -DRT_BENCHMARK (see the teensy41_bench environment), setup()
+// runs these instead of rendering and prints one line per measurement to
+// the serial port. Every benchmark traces the same fixed set of rays (or
+// renders the same frame from the same seed) so the numbers are comparable
+// between builds.
+
+// Define the number of rays per measurement
+#ifndef RT_BENCH_RAYS
+#define RT_BENCH_RAYS 20000
+#endif
+
+// Define the camera settings used for the full-frame benchmarks
+#ifndef RT_BENCH_SPP
+#define RT_BENCH_SPP 4
+#endif
+#ifndef RT_BENCH_DEPTH
+#define RT_BENCH_DEPTH 10
+#endif
+
+// Define the settings of the radiance cache comparison
+#ifndef RT_BENCH_REF_SPP
+#define RT_BENCH_REF_SPP 256
+#endif
+#ifndef RT_BENCH_CACHE_RECORDS
+#define RT_BENCH_CACHE_RECORDS 2048
+#endif
+#ifndef RT_BENCH_CACHE_STRIDE
+#define RT_BENCH_CACHE_STRIDE 4   // renders every 4th pixel of every 4th row
+#endif
+
+// Define the fixed set of rays: primary-like rays from the camera position
+// and secondary-like rays leaving the ground plane
+inline std::vector<ray> bench_rays(int count) {
+    std::vector<ray> rays;
+    rays.reserve(count);
+    srand(12345);
+    for (int k = 0; k < count; k++) {
+        if (k % 2 == 0) {
+            point3 origin(13, 2, 3);
+            point3 target(random_float(-6, 6), random_float(-1, 3), random_float(-4, 4));
+            rays.push_back(ray(origin, target - origin));
+        } else {
+            point3 origin(random_float(-11, 11), 0.001, random_float(-11, 11));
+            rays.push_back(ray(origin, Vector3(0, 1, 0) + random_unit_vector()));
+        }
+    }
+    return rays;
+}
+
+// Define the cycle counter read around each measured loop (0 where there is none)
+inline uint32_t bench_cycles() {
+#ifdef __IMXRT1062__
+    return ARM_DWT_CYCCNT;
+#else
+    return 0;
+#endif
+}
+
+// Define the report line shared by all benchmarks
+inline void bench_report(Print& out, const char* name, uint32_t rays, uint32_t us, uint32_t cycles, float checksum) {
+    out.printf("bench: %-32s %7lu rays %9lu us %10.0f rays/s ", name, (unsigned long)rays, (unsigned long)us,
+               us ? rays * 1e6f / us : 0.0f);
+    if (cycles && rays) {
+        out.printf("%8.0f cycles/ray", float(cycles) / rays);
+    } else {
+        out.printf("%8s cycles/ray", "n/a");
+    }
+    out.printf(" (check %.3f)\n", checksum);
+}
+
+// Define the reference for two-phase intersection: evaluate every attribute of
+// each candidate that is closer so far, in one call, and copy the full record,
+// as the original hit() did
+inline bool eager_hit(const hittable_list& world, const ray& r, interval ray_t, hit_record& rec) {
+    hit_record temp_rec;
+    bool hit_anything = false;
+    auto closest_so_far = ray_t.max;
+    for (const auto& object : world.objects) {
+        if (object->hit_eager(r, interval(ray_t.min, closest_so_far), temp_rec)) {
+            hit_anything = true;
+            closest_so_far = temp_rec.t;
+            rec = temp_rec;
+        }
+    }
+    return hit_anything;
+}
+
+inline void bench_intersection(Print& out, const hittable_list& world, const std::vector<ray>& rays) {
+    // Compare eager attribute evaluation against the deferred world.hit()
+    float checksum = 0;
+    uint32_t start = micros();
+    uint32_t start_cycles = bench_cycles();
+    for (const auto& r : rays) {
+        hit_record rec;
+        if (eager_hit(world, r, interval(0.001, inf), rec)) {
+            checksum += rec.normal.y();
+        }
+    }
+    uint32_t cycles = bench_cycles() - start_cycles;
+    bench_report(out, "closest hit (eager attributes)", rays.size(), micros() - start, cycles, checksum);
+
+    checksum = 0;
+    start = micros();
+    start_cycles = bench_cycles();
+    for (const auto& r : rays) {
+        hit_record rec;
+        if (world.hit(r, interval(0.001, inf), rec)) {
+            checksum += rec.normal.y();
+        }
+    }
+    cycles = bench_cycles() - start_cycles;
+    bench_report(out, "closest hit (deferred attributes)", rays.size(), micros() - start, cycles, checksum);
+}
+
+inline void bench_sample_maps(Print& out, const hittable_list& world, camera cam, Adafruit_ILI9341& tft) {
+    // Compare region-of-interest and foveated renders against a uniform one
+    cam.sample_per_pixel = RT_BENCH_SPP;
+    cam.max_depth = RT_BENCH_DEPTH;
+    int w = tft.width(), h = tft.height();
+
+    // The hero spheres sit around the middle of the frame
+    sample_map rect;
+    rect.set_rect(w / 8, h / 4, w * 7 / 8, h * 3 / 4, 0.1);
+    sample_map radial;
+    radial.set_radial(w / 2, h / 2, h / 4, h * 3 / 4, 0.1);
+    sample_map crop;
+    crop.set_crop(w / 8, h / 4, w * 7 / 8, h * 3 / 4);
+
+    const char* names[] = { "uniform", "rect roi", "radial falloff", "crop" };
+    const sample_map* maps[] = { nullptr, &rect, &radial, &crop };
+    uint32_t uniform_us = 0;
+    for (int m = 0; m < 4; m++) {
+        srand(12345);
+        cam.rate_map = maps[m];
+        cam.render(tft, world);
+        if (m == 0) {
+            uniform_us = cam.last_render_us;
+        }
+        out.printf("bench: sample map %-16s %d spp %9lu us %6.2fx vs uniform\n",
+                   names[m], RT_BENCH_SPP, (unsigned long)cam.last_render_us,
+                   cam.last_render_us ? float(uniform_us) / cam.last_render_us : 0.0f);
+    }
+}
+
+inline void bench_wavefront(Print& out, const hittable_list& world, camera cam, Adafruit_ILI9341& tft) {
+    // Compare the depth-first kernel against the wavefront integrator at a few batch sizes
+    cam.sample_per_pixel = RT_BENCH_SPP;
+    cam.max_depth = RT_BENCH_DEPTH;
+    cam.rate_map = nullptr;
+
+    srand(12345);
+    cam.render(tft, world);
+    uint32_t depth_first_us = cam.last_render_us;
+    out.printf("bench: depth-first         %d spp %9lu us\n", RT_BENCH_SPP, (unsigned long)depth_first_us);
+
+    static const char* tiers[TIER_COUNT] = { "DTCM", "OCRAM", "PSRAM", "heap" };
+    static const int batches[] = { 64, 256, 1024 };
+    for (int batch : batches) {
+        ray_queue queue(batch);
+        srand(12345);
+        cam.render_wavefront(tft, world, queue);
+        out.printf("bench: wavefront batch %4d %d spp %9lu us %6.2fx vs depth-first, %10.0f rays/s, %lu bytes in %s\n",
+                   batch, RT_BENCH_SPP, (unsigned long)cam.last_render_us,
+                   cam.last_render_us ? float(depth_first_us) / cam.last_render_us : 0.0f,
+                   cam.last_render_us ? queue.rays_traced * 1e6f / cam.last_render_us : 0.0f,
+                   (unsigned long)queue.bytes(), tiers[scene_arena().tier_of(queue.data())]);
+    }
+}
+
+inline void bench_progressive(Adafruit_ILI9341& tft, const hittable_list& world, camera& cam, const std::vector<Color>& reference,
+                              int stride, const int* pass_spp, int passes, float* error, uint32_t* us) {
+    // Render every stride-th pixel of the frame in passes of pass_spp samples, keeping the
+    // running sum (and any cache) across passes; stores the RMS error against the reference
+    // and the time so far after each pass
+    int w = tft.width() / stride, h = tft.height() / stride;
+    std::vector<Color> sum(w * h, Color(0, 0, 0));
+    int total = 0;
+    uint32_t elapsed = 0;
+    srand(777);
+    for (int k = 0; k < passes; k++) {
+        uint32_t start = micros();
+        for (int j = 0; j < h; j++) {
+            for (int i = 0; i < w; i++) {
+                sum[j * w + i] += float(pass_spp[k]) * cam.probe_pixel(tft, world, i * stride, j * stride, pass_spp[k]);
+            }
+        }
+        elapsed += micros() - start;
+        total += pass_spp[k];
+
+        float squared = 0;
+        for (int p = 0; p < w * h; p++) {
+            Vector3 d = sum[p] / float(total) - reference[p];
+            squared += d.length_squared();
+        }
+        error[k] = std::sqrt(squared / (3.0f * w * h));
+        us[k] = elapsed;
+    }
+}
+
+inline void bench_radiance_cache(Print& out, const hittable_list& world, camera cam, Adafruit_ILI9341& tft) {
+    // Compare the time brute-force path tracing needs to reach the error of the cached render,
+    // over the whole frame with one cache kept across all passes so that records are reused
+    cam.max_depth = RT_BENCH_DEPTH;
+    cam.rate_map = nullptr;
+    cam.cache = nullptr;
+    const int stride = RT_BENCH_CACHE_STRIDE;
+    int w = tft.width() / stride, h = tft.height() / stride;
+
+    // Reference: brute force at many samples
+    std::vector<Color> reference(w * h);
+    srand(4242);
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            reference[j * w + i] = cam.probe_pixel(tft, world, i * stride, j * stride, RT_BENCH_REF_SPP);
+        }
+    }
+
+    // Both renders double their sample count every pass: 1, 2, 4, ... 32 spp in total
+    static const int pass_spp[] = { 1, 1, 2, 4, 8, 16 };
+    const int passes = sizeof(pass_spp) / sizeof(pass_spp[0]);
+    float brute_error[passes], cached_error[passes];
+    uint32_t brute_us[passes], cached_us[passes];
+    bench_progressive(tft, world, cam, reference, stride, pass_spp, passes, brute_error, brute_us);
+
+    radiance_cache cache(RT_BENCH_CACHE_RECORDS);
+    cam.cache = &cache;
+    bench_progressive(tft, world, cam, reference, stride, pass_spp, passes, cached_error, cached_us);
+
+    int spp = 0;
+    for (int k = 0; k < passes; k++) {
+        spp += pass_spp[k];
+        out.printf("bench: brute force %3d spp %9lu us rms %.4f\n", spp, (unsigned long)brute_us[k], brute_error[k]);
+    }
+    spp = 0;
+    for (int k = 0; k < passes; k++) {
+        spp += pass_spp[k];
+        float error = cached_error[k];
+
+        // Interpolate the brute force time at equal error (log-log between the bracketing passes)
+        float equal_us = -1;
+        for (int b = 1; b < passes; b++) {
+            if (brute_error[b] <= error && brute_error[b - 1] > error) {
+                float f = std::log(brute_error[b - 1] / error) / std::log(brute_error[b - 1] / brute_error[b]);
+                equal_us = std::exp(std::log(float(brute_us[b - 1])) + f * std::log(float(brute_us[b]) / brute_us[b - 1]));
+            }
+        }
+        if (brute_error[0] <= error) {
+            equal_us = brute_us[0];
+        }
+
+        out.printf("bench: cached      %3d spp %9lu us rms %.4f, brute force at equal error ",
+                   spp, (unsigned long)cached_us[k], error);
+        if (equal_us < 0) {
+            out.printf("> %lu us\n", (unsigned long)brute_us[passes - 1]);
+        } else {
+            out.printf("%.0f us (%.2fx)\n", equal_us, cached_us[k] ? equal_us / cached_us[k] : 0.0f);
+        }
+    }
+    out.printf("bench: ");
+    cache.print(out);
+}
+
+#ifdef RT_BENCH_MESHES
+inline void bench_meshes(Print& out) {
+    // Trace rays from a sphere around each mesh towards random points in its bounds
+    auto mat = make_shared<lambertian>(Color(0.5, 0.5, 0.5));
+    for (const mesh_asset& asset : mesh_assets) {
+        triangle_mesh mesh(asset.data, mat);
+        if (!mesh.valid()) {
+            out.printf("bench: mesh %s is not a valid mesh blob\n", asset.name);
+            continue;
+        }
+        point3 lo, hi;
+        mesh.bounds(lo, hi);
+        point3 center = 0.5f * (lo + hi);
+        float radius = 0.5f * (hi - lo).length();
+
+        std::vector<ray> rays;
+        rays.reserve(RT_BENCH_RAYS);
+        srand(12345);
+        for (int k = 0; k < RT_BENCH_RAYS; k++) {
+            point3 origin = center + 2 * radius * random_unit_vector();
+            point3 target(random_float(lo[0], hi[0]), random_float(lo[1], hi[1]), random_float(lo[2], hi[2]));
+            rays.push_back(ray(origin, target - origin));
+        }
+
+        float checksum = 0;
+        uint32_t start = micros();
+        uint32_t start_cycles = bench_cycles();
+        for (const auto& r : rays) {
+            hit_record rec;
+            if (mesh.hit(r, interval(0.001, inf), rec)) {
+                checksum += rec.normal.y();
+            }
+        }
+        uint32_t cycles = bench_cycles() - start_cycles;
+        uint32_t us = micros() - start;
+
+        char name[48];
+        snprintf(name, sizeof(name), "mesh %lu tris %.1f B/tri", (unsigned long)mesh.triangles(),
+                 float(mesh.bytes()) / mesh.triangles());
+        bench_report(out, name, rays.size(), us, cycles, checksum);
+    }
+}
+#endif
+
+inline void run_benchmarks(Print& out, const hittable_list& world, const camera& cam, Adafruit_ILI9341& tft) {
+    // Run every benchmark on the given scene
+    std::vector<ray> rays = bench_rays(RT_BENCH_RAYS);
+#ifdef RT_NO_PLACEMENT
+    out.printf("bench: placement off (scene on the heap)\n");
+#else
+    out.printf("bench: placement on (scene in DTCM first, hot kernels FASTRUN)\n");
+#endif
+    print_memory_map(out);
+    out.printf("bench: %u objects, %u rays\n", (unsigned)world.objects.size(), (unsigned)rays.size());
+    bench_intersection(out, world, rays);
+    bench_sample_maps(out, world, cam, tft);
+    bench_wavefront(out, world, cam, tft);
+    bench_radiance_cache(out, world, cam, tft);
+#ifdef RT_BENCH_MESHES
+    bench_meshes(out);
+#endif
+}
+
+#endif
@@ -4,8 +4,15 @@
 #include "ray_tracing.h"
 #include "hittable.h"
 #include "material.h"
+#include "frame_stream.h"
+#include "render_budget.h"
+#include "sample_map.h"
+#include "wavefront.h"
+#include "radiance_cache.h"
+#include "render_state.h"
 #include <Adafruit_ILI9341.h>
 #include <limits>
+#include <vector>
 
 const float infi = std::numeric_limits<float>::infinity();
 
@@ -21,28 +28,258 @@ class camera {
         float defocus_angle;
         float focus_distance;
 
+        // Optional sink that receives every finished row (nullptr disables streaming)
+        frame_stream* stream = nullptr;
+
+        // Optional per-pixel sampling-rate map and crop (nullptr renders uniformly)
+        const sample_map* rate_map = nullptr;
+
+        // Optional radiance cache for secondary diffuse bounces (nullptr traces them fully)
+        radiance_cache* cache = nullptr;
+
+        // Define the wall-clock time of the last render
+        uint32_t last_render_us = 0;
+
         void render(Adafruit_ILI9341& tft, const hittable& world) {
             // Render the scene to the display
 
             // Initialize the camera
             initialize(tft);
+            uint32_t start = micros();
+
+            // Announce the frame to the host and keep a row buffer for streaming
+            std::vector<uint16_t> row;
+            if (stream) {
+                stream->begin_frame(tft.width(), tft.height());
+                row.resize(tft.width());
+            }
 
             // Render the scene
             for (int j = tft.height() - 1; j >= 0; --j) {
-                for (int i = 0; i < tft.width(); ++i) {
-                    Color pixel_color(0, 0, 0);
-                    for (int sample = 0; sample < sample_per_pixel; ++sample) {
-                        auto u = (float(i) + random_float()) / (tft.width() - 1);
-                        auto v = (float(j) + random_float()) / (tft.height() - 1);
-                        ray r(camera_origin, viewport_upper_left + u * horizontal + v * vertical - camera_origin);
-                        pixel_color += ray_color(r, max_depth, world);
+                render_row(tft, world, j, sample_per_pixel, max_depth, row);
+            }
+
+            // Close the frame and give the host a moment to drain the buffer
+            if (stream) {
+                stream->end_frame();
+                stream->flush(stream->stall_timeout_us);
+            }
+            last_render_us = micros() - start;
+        }
+
+        void render_budgeted(Adafruit_ILI9341& tft, const hittable& world, uint32_t budget_us, render_budget& budget) {
+            // Render the best image that fits in budget_us, treating
+            // sample_per_pixel and max_depth as upper bounds
+
+            // Initialize the camera
+            initialize(tft);
+            uint32_t start = micros();
+
+            // Weigh each row by its sampling rate so the budget follows the map
+            std::vector<float> row_weights(tft.height());
+            float total_weight = 0;
+            for (int j = 0; j < tft.height(); ++j) {
+                row_weights[j] = rate_map ? rate_map->row_weight(j, tft.width(), tft.height()) : float(tft.width());
+                total_weight += row_weights[j];
+            }
+            budget.begin(budget_us, sample_per_pixel, max_depth, tft.height(), total_weight);
+
+            std::vector<uint16_t> row;
+            if (stream) {
+                stream->begin_frame(tft.width(), tft.height());
+                row.resize(tft.width());
+            }
+
+            // Visit the rows in bit-reversed stripes of 8 (0, 4, 2, 6, 1, 5, 3, 7)
+            static const int stripe_order[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+            for (int stripe = 0; stripe < 8; ++stripe) {
+                for (int j = tft.height() - 1 - stripe_order[stripe]; j >= 0; j -= 8) {
+                    // Rows outside the crop cost nothing and need no decision
+                    if (row_weights[j] <= 0) {
+                        continue;
+                    }
+                    budget.plan_row(j);
+                    uint32_t samples = render_row(tft, world, j, budget.samples(), budget.depth_cap(), row);
+                    budget.finish_row(row_weights[j], samples);
+                }
+            }
+
+            if (stream) {
+                stream->end_frame();
+                stream->flush(stream->stall_timeout_us);
+            }
+            budget.end();
+            last_render_us = micros() - start;
+        }
+
+        void render_wavefront(Adafruit_ILI9341& tft, const hittable& world, ray_queue& queue) {
+            // Render the scene with the wavefront integrator, queue.size() pixels
+            // at a time (rate_map is not applied in this mode)
+
+            // Initialize the camera
+            initialize(tft);
+            uint32_t start = micros();
+            int width = tft.width(), height = tft.height();
+            int pixels = width * height;
+
+            std::vector<uint16_t> row;
+            if (stream) {
+                stream->begin_frame(width, height);
+                row.resize(width);
+            }
+
+            // Walk the frame in the same order as render(), one batch of pixels at a time
+            for (int first = 0; first < pixels; first += queue.size()) {
+                int batch = pixels - first < queue.size() ? pixels - first : queue.size();
+                queue.clear_accumulators(batch);
+
+                for (int sample = 0; sample < sample_per_pixel; ++sample) {
+                    // Stage: generate one camera ray per pixel of the batch
+                    queue.count = 0;
+                    for (int p = 0; p < batch; ++p) {
+                        int q = first + p;
+                        queue.push(camera_ray(q % width, height - 1 - q / width, width, height), uint16_t(p));
+                    }
+
+                    // Advance the whole batch one bounce at a time
+                    for (int depth = 0; depth < max_depth && queue.count > 0; ++depth) {
+                        queue.bounce(world);
+                    }
+                }
+
+                // Resolve the batch to the display, one row segment at a time
+                float scale = 1.0f / sample_per_pixel;
+                for (int p = 0; p < batch; ++p) {
+                    int q = first + p;
+                    int i = q % width, j = height - 1 - q / width;
+                    uint16_t rgb565 = writeColor(i, j, Color(queue.ar[p], queue.ag[p], queue.ab[p]) * scale, tft);
+                    if (stream) {
+                        row[i] = rgb565;
+                        bool row_done = i == width - 1;
+                        if (row_done || p == batch - 1) {
+                            // The segment starts where the batch entered this row
+                            int segment_start = i - p > 0 ? i - p : 0;
+                            stream->send_tile(segment_start, j, i + 1 - segment_start, 1, row.data() + segment_start);
+                        }
+                        stream->pump();
+                    }
+                }
+            }
+
+            if (stream) {
+                stream->end_frame();
+                stream->flush(stream->stall_timeout_us);
+            }
+            last_render_us = micros() - start;
+        }
+
+        bool render_step(Adafruit_ILI9341& tft, const hittable& world, render_state& state, uint32_t budget_us) {
+            // Advance a progressive render by whole tile passes until budget_us is spent
+            // (at least one pass) and return whether it is finished; rate_map and stream
+            // are not applied in this mode
+            initialize(tft);
+            uint32_t start = micros();
+            int width = tft.width(), height = tft.height();
+
+            do {
+                int tile = state.next_tile();
+                if (tile < 0) {
+                    break;
+                }
+
+                // Every (tile, pass) has its own random stream, so resuming is exact
+                uint32_t pass = state.passes[tile];
+                int spp = state.pass_samples(pass);
+                srand(state.stream_seed(tile, pass));
+
+                int x0, y0;
+                state.tile_origin(tile, x0, y0);
+                float* accum = state.tile_accum(tile);
+                uint16_t* counts = state.tile_counts(tile);
+                for (int y = 0; y < state.tile_size; ++y) {
+                    for (int x = 0; x < state.tile_size; ++x) {
+                        int i = x0 + x, j = y0 + y;
+                        if (i >= width || j >= height) {
+                            continue;
+                        }
+                        int k = y * state.tile_size + x;
+                        Color sum = sample_pixel(i, j, spp, max_depth, width, height, world) * float(spp);
+                        accum[3 * k] += sum[0];
+                        accum[3 * k + 1] += sum[1];
+                        accum[3 * k + 2] += sum[2];
+                        counts[k] += spp;
+                        writeColor(i, j, Color(accum[3 * k], accum[3 * k + 1], accum[3 * k + 2]) / counts[k], tft);
+                    }
+                }
+                state.passes[tile] = pass + 1;
+                state.dirty[tile] = 1;
+            } while (micros() - start < budget_us);
+
+            state.render_us += micros() - start;
+            return state.done();
+        }
+
+        void show(Adafruit_ILI9341& tft, const render_state& state) const {
+            // Draw every pixel of a (restored) render state that has samples
+            for (int tile = 0; tile < state.tile_count(); ++tile) {
+                int x0, y0;
+                state.tile_origin(tile, x0, y0);
+                const float* accum = state.tile_accum(tile);
+                const uint16_t* counts = state.tile_counts(tile);
+                for (int k = 0; k < state.tile_pixels(); ++k) {
+                    int i = x0 + k % state.tile_size, j = y0 + k / state.tile_size;
+                    if (counts[k] > 0 && i < tft.width() && j < tft.height()) {
+                        writeColor(i, j, Color(accum[3 * k], accum[3 * k + 1], accum[3 * k + 2]) / counts[k], tft);
                     }
-                    pixel_color *= pixel_samples_scale;
-                    writeColor(i, j, pixel_color, tft);
                 }
             }
         }
 
+        uint32_t fingerprint(const hittable& world, int width, int height) const {
+            // Hash the camera settings and what the scene looks like along a fixed
+            // spiral of probe rays, so a checkpoint is never resumed into another render
+            uint32_t h = 2166136261u;
+            auto mix = [&h](const void* data, size_t len) {
+                const uint8_t* p = static_cast<const uint8_t*>(data);
+                for (size_t k = 0; k < len; k++) {
+                    h = (h ^ p[k]) * 16777619u;
+                }
+            };
+            float settings[] = { vfov, defocus_angle, focus_distance, lookfrom[0], lookfrom[1], lookfrom[2],
+                                 lookat[0], lookat[1], lookat[2], vup[0], vup[1], vup[2] };
+            int32_t sizes[] = { sample_per_pixel, max_depth, width, height };
+            mix(settings, sizeof(settings));
+            mix(sizes, sizeof(sizes));
+
+            Vector3 forward = unit_vector(lookat - lookfrom);
+            for (int k = 0; k < 64; ++k) {
+                // Golden-angle spiral over a cone around the view direction
+                float r = 0.5f * std::sqrt((k + 0.5f) / 64.0f);
+                float phi = 2.39996323f * k;
+                Vector3 side = unit_vector(cross(forward, vup));
+                Vector3 up = cross(side, forward);
+                ray probe(lookfrom, forward + r * std::cos(phi) * side + r * std::sin(phi) * up);
+
+                hit_record rec;
+                int32_t quantized[5] = { -1, 0, 0, 0, -1 };
+                if (world.hit(probe, interval(0.001, infi), rec)) {
+                    quantized[0] = int32_t(rec.t * 1000.0f);
+                    quantized[1] = int32_t(rec.normal[0] * 1000.0f);
+                    quantized[2] = int32_t(rec.normal[1] * 1000.0f);
+                    quantized[3] = int32_t(rec.normal[2] * 1000.0f);
+                    quantized[4] = rec.mat_ptr->kind;
+                }
+                mix(quantized, sizeof(quantized));
+            }
+            return h;
+        }
+
+        Color probe_pixel(Adafruit_ILI9341& tft, const hittable& world, int i, int j, int spp) {
+            // Returns the average of spp samples through pixel (i, j) without drawing it
+            initialize(tft);
+            return sample_pixel(i, j, spp, max_depth, tft.width(), tft.height(), world);
+        }
+
     private:
         // Camera properties
         point3 camera_origin;
@@ -92,6 +329,62 @@ class camera {
         defocus_disk_v = v * defocus_radius;
     }
 
+    uint32_t render_row(Adafruit_ILI9341& tft, const hittable& world, int j, int spp, int depth, std::vector<uint16_t>& row) {
+        // Render, display and (optionally) stream one row of pixels, returning the samples taken
+
+        // Restrict the row to the crop rectangle
+        int begin = 0, end = tft.width();
+        if (rate_map && rate_map->cropped()) {
+            if (j < rate_map->crop_y0 || j >= rate_map->crop_y1) {
+                return 0;
+            }
+            begin = rate_map->crop_x0 > 0 ? rate_map->crop_x0 : 0;
+            end = rate_map->crop_x1 < tft.width() ? rate_map->crop_x1 : int(tft.width());
+        }
+
+        uint32_t samples = 0;
+        for (int i = begin; i < end; ++i) {
+            // Scale the samples and the depth by the map
+            int pixel_spp = spp, pixel_depth = depth;
+            if (rate_map) {
+                pixel_spp = rate_map->samples(i, j, tft.width(), tft.height(), spp);
+                pixel_depth = rate_map->depth(i, j, tft.width(), tft.height(), depth);
+            }
+            samples += pixel_spp;
+
+            Color pixel_color = sample_pixel(i, j, pixel_spp, pixel_depth, tft.width(), tft.height(), world);
+            uint16_t rgb565 = writeColor(i, j, pixel_color, tft);
+
+            // Let queued bytes trickle out while the next pixel renders
+            if (stream) {
+                row[i] = rgb565;
+                stream->pump();
+            }
+        }
+
+        // Ship the finished row as one tile
+        if (stream && end > begin) {
+            stream->send_tile(begin, j, end - begin, 1, row.data() + begin);
+        }
+        return samples;
+    }
+
+    RT_HOT Color sample_pixel(int i, int j, int spp, int depth, int width, int height, const hittable& world) const {
+        // Average spp camera samples through pixel (i, j)
+        Color pixel_color(0, 0, 0);
+        for (int sample = 0; sample < spp; ++sample) {
+            pixel_color += ray_color(camera_ray(i, j, width, height), depth, world);
+        }
+        return pixel_color * (1.0f / spp);
+    }
+
+    ray camera_ray(int i, int j, int width, int height) const {
+        // Returns a jittered ray through pixel (i, j)
+        auto u = (float(i) + random_float()) / (width - 1);
+        auto v = (float(j) + random_float()) / (height - 1);
+        return ray(camera_origin, viewport_upper_left + u * horizontal + v * vertical - camera_origin);
+    }
+
     ray get_ray(int i, int j) const {
         // Returns a ray from the camera origin to the viewport pixel (i, j).
 
@@ -116,7 +409,16 @@ class camera {
         return camera_origin + (p[0] * defocus_disk_u) + (p[1] * defocus_disk_v);
     }
 
-    Color ray_color(const ray& r, int depth, const hittable& world) const {
+    RT_HOT Color ray_color(const ray& r, int depth, const hittable& world) const {
+        // Returns the radiance along a camera ray
+        float distance;
+        return trace(r, depth, world, false, distance);
+    }
+
+    RT_HOT Color trace(const ray& r, int depth, const hittable& world, bool secondary, float& distance) const {
+        // Returns the radiance along r and the distance to the first hit (infinity on a miss)
+        distance = infi;
+
         // Establish the base case for the recursion
         if (depth <= 0) {
             return Color(0, 0, 0);
@@ -125,11 +427,24 @@ class camera {
         // Check if the ray intersects the world
         hit_record rec;
         if (world.hit(r, interval(0.001, infi), rec)) {
+            distance = rec.t;
+
+            // Secondary diffuse bounces read the radiance cache instead of tracing further
+            // (and trace on as usual once the cache is full and has nothing here)
+            if (secondary && cache && !cache->busy && rec.mat_ptr->kind == MATERIAL_LAMBERTIAN) {
+                Color radiance;
+                if (cached_radiance(rec, depth, world, radiance)) {
+                    const lambertian* diffuse = static_cast<const lambertian*>(rec.mat_ptr.get());
+                    return diffuse->albedo * radiance;
+                }
+            }
+
             ray scattered;
             Color attenuation;
             if (rec.mat_ptr->scatter(r, rec, attenuation, scattered)) {
                 // Recursively calculate the scattered ray color
-                return attenuation * ray_color(scattered, depth-1, world);
+                float next_distance;
+                return attenuation * trace(scattered, depth-1, world, true, next_distance);
             }
             return Color(0, 0, 0);
         }
@@ -139,6 +454,53 @@ class camera {
         auto t = 0.5 * (unit_direction.y() + 1.0);
         return (1.0 - t) * Color(1.0, 1.0, 1.0) + t * Color(0.5, 0.7, 1.0);
     }
+
+    bool cached_radiance(const hit_record& rec, int depth, const hittable& world, Color& value) const {
+        // Finds the mean incoming radiance at a diffuse hit, from the cache if possible;
+        // returns false when it would need a new record and the pool is full
+        if (cache->lookup(rec.p, rec.normal, value)) {
+            return true;
+        }
+        if (cache->full()) {
+            cache->rejected++;
+            return false;
+        }
+
+        // Build a new record from a cosine-weighted hemisphere of rays (traced without the cache)
+        cache->busy = true;
+        int n = cache->samples;
+        Color sum(0, 0, 0);
+        Vector3 grad_r, grad_g, grad_b;
+        float inverse_distance_sum = 0;
+        for (int k = 0; k < n; ++k) {
+            Vector3 direction = rec.normal + random_unit_vector();
+            if (direction.near_zero()) {
+                direction = rec.normal;
+            }
+            direction = unit_vector(direction);
+
+            float distance;
+            Color radiance = trace(ray(rec.p, direction), depth - 1, world, true, distance);
+            sum += radiance;
+            if (distance < infi) {
+                // First-order change of the sample's contribution when p slides in the
+                // tangent plane (solid angle and cosine both grow by t.d / distance)
+                inverse_distance_sum += 1.0f / distance;
+                Vector3 tangent = direction - dot(direction, rec.normal) * rec.normal;
+                Vector3 g = (3.0f / fmax(distance, cache->min_radius)) * tangent;
+                grad_r += radiance[0] * g;
+                grad_g += radiance[1] * g;
+                grad_b += radiance[2] * g;
+            }
+        }
+        cache->busy = false;
+
+        float scale = 1.0f / n;
+        value = sum * scale;
+        float radius = inverse_distance_sum > 0 ? n / inverse_distance_sum : cache->max_radius;
+        cache->insert(rec.p, rec.normal, value, grad_r * scale, grad_g * scale, grad_b * scale, radius);
+        return true;
+    }
 };  
 
 #endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include "render_state.h"
+
+#ifdef ARDUINO_TEENSY41
+#include <SD.h>
+#endif
+#ifndef ARDUINO
+#include <stdio.h>
+#include <chrono>
+#endif
+
+// Checkpoint file format
+//
+//   checkpoint_header
+//   tile_count x tile record: passes u32 | crc32 u32 | counts u16[] | radiance f32[3][]
+//
+// All integers are little endian and every tile record sits at a fixed
+// offset, so a checkpoint only rewrites the tiles that changed. The CRC
+// covers the pass count and the pixel data; a tile torn by a power cut
+// fails it and is simply rendered again. The header is written once when
+// the file is created, and a header whose hash, size or sampling plan does
+// not match the current render starts a new file.
+
+// Define the format constants
+const uint32_t CHECKPOINT_MAGIC = 0x4B435452;  // "RTCK"
+const uint16_t CHECKPOINT_VERSION = 1;
+
+// Define the checkpoint header
+struct checkpoint_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t tile_size;
+    uint16_t width;
+    uint16_t height;
+    uint16_t target_spp;
+    uint16_t samples_per_pass;
+    uint32_t seed;
+    uint32_t hash;
+    uint32_t tile_count;
+    uint32_t tile_bytes;   // size of one tile record
+};
+
+// Define the storage interface the checkpoint reads and writes through
+class checkpoint_store {
+    public:
+        virtual ~checkpoint_store() = default;
+
+        // Open the file for reading and writing, creating it if needed
+        virtual bool open(const char* path) = 0;
+
+        // Read or write len bytes at a byte offset and return whether all of them made it
+        virtual bool read(uint32_t offset, void* data, size_t len) = 0;
+        virtual bool write(uint32_t offset, const void* data, size_t len) = 0;
+
+        // Push written data to the medium
+        virtual void flush() = 0;
+};
+
+#ifdef ARDUINO_TEENSY41
+// Define the store for the Teensy 4.1 built-in SD card
+class sd_store : public checkpoint_store {
+    public:
+        virtual bool open(const char* path) override {
+            if (!SD.begin(BUILTIN_SDCARD)) {
+                return false;
+            }
+            file = SD.open(path, FILE_WRITE);
+            return bool(file);
+        }
+
+        virtual bool read(uint32_t offset, void* data, size_t len) override {
+            return file.seek(offset) && file.read(data, len) == int(len);
+        }
+
+        virtual bool write(uint32_t offset, const void* data, size_t len) override {
+            return file.seek(offset) && file.write(static_cast<const uint8_t*>(data), len) == len;
+        }
+
+        virtual void flush() override {
+            file.flush();
+        }
+
+    private:
+        File file;
+};
+#endif
+
+#ifndef ARDUINO
+// Define the store for a file on the host
+class file_store : public checkpoint_store {
+    public:
+        virtual ~file_store() override {
+            if (file) {
+                fclose(file);
+            }
+        }
+
+        virtual bool open(const char* path) override {
+            file = fopen(path, "r+b");
+            if (!file) {
+                file = fopen(path, "w+b");
+            }
+            return file != nullptr;
+        }
+
+        virtual bool read(uint32_t offset, void* data, size_t len) override {
+            return fseek(file, long(offset), SEEK_SET) == 0 && fread(data, 1, len, file) == len;
+        }
+
+        virtual bool write(uint32_t offset, const void* data, size_t len) override {
+            return fseek(file, long(offset), SEEK_SET) == 0 && fwrite(data, 1, len, file) == len;
+        }
+
+        virtual void flush() override {
+            fflush(file);
+        }
+
+    private:
+        FILE* file = nullptr;
+};
+#endif
+
+// Define the checkpoint class
+class render_checkpoint {
+    public:
+        // Define the share of render time checkpoints may take, and the shortest interval
+        float max_overhead = 0.02;
+        uint32_t min_interval_us = 10000000;
+
+        // Define the statistics
+        uint32_t saves = 0;
+        uint32_t tiles_written = 0;
+        uint32_t tiles_restored = 0;
+        uint32_t tiles_rejected = 0;  // torn or corrupt records found on resume
+        uint64_t bytes_written = 0;
+        uint64_t write_us = 0;
+        uint32_t last_save_us = 0;
+
+        render_checkpoint(checkpoint_store& s) : store(s) {}
+
+        bool active() const { return is_active; }
+
+        bool resume(const char* path, render_state& state) {
+            // Load the matching tiles of the checkpoint at path into state, or start a new
+            // checkpoint there; returns true if any work was restored
+            is_active = false;
+            if (!state.ready() || !store.open(path)) {
+                return false;
+            }
+            last_save_render_us = state.render_us;
+
+            checkpoint_header expected = header_for(state);
+            checkpoint_header found;
+            if (!store.read(0, &found, sizeof(found)) || memcmp(&found, &expected, sizeof(found)) != 0) {
+                is_active = create(state);
+                return false;
+            }
+
+            for (int t = 0; t < state.tile_count(); t++) {
+                uint32_t record[2];
+                uint32_t offset = tile_offset(state, t);
+                bool ok = store.read(offset, record, sizeof(record))
+                          && store.read(offset + 8, state.tile_counts(t), counts_bytes(state))
+                          && store.read(offset + 8 + counts_bytes(state), state.tile_accum(t), accum_bytes(state))
+                          && record[0] <= uint32_t(state.total_passes())
+                          && record[1] == tile_crc(state, t, record[0]);
+                if (ok) {
+                    state.passes[t] = record[0];
+                    tiles_restored += record[0] > 0;
+                } else {
+                    state.clear_tile(t);
+                    state.dirty[t] = 1;
+                    tiles_rejected++;
+                }
+            }
+            is_active = true;
+            return tiles_restored > 0;
+        }
+
+        bool due(const render_state& state) const {
+            // A checkpoint is due once enough render time has passed to keep the overhead bounded
+            return is_active && state.render_us - last_save_render_us >= interval_us;
+        }
+
+        bool save(render_state& state) {
+            // Write the tiles that changed since the last checkpoint
+            if (!is_active) {
+                return false;
+            }
+            uint32_t start = now_us();
+            bool ok = true;
+            for (int t = 0; t < state.tile_count() && ok; t++) {
+                if (state.dirty[t]) {
+                    ok = write_tile(state, t);
+                    state.dirty[t] = !ok;
+                }
+            }
+            store.flush();
+            last_save_us = now_us() - start;
+            write_us += last_save_us;
+            last_save_render_us = state.render_us;
+            saves++;
+
+            // Space the checkpoints out so their cost stays under max_overhead of render time
+            uint32_t interval = uint32_t(last_save_us / max_overhead);
+            interval_us = interval > min_interval_us ? interval : min_interval_us;
+            return ok;
+        }
+
+        float overhead(const render_state& state) const {
+            return state.render_us ? float(write_us) / float(state.render_us) : 0.0f;
+        }
+
+        void print(Print& out, const render_state& state) const {
+            out.printf("checkpoint: %lu saves, %lu tiles (%.1f KB) in %.3f s, %.2f%% of %.1f s rendering, "
+                       "%lu tiles restored, %lu rejected\n",
+                       (unsigned long)saves, (unsigned long)tiles_written, bytes_written / 1024.0,
+                       write_us * 1e-6, 100.0f * overhead(state), state.render_us * 1e-6,
+                       (unsigned long)tiles_restored, (unsigned long)tiles_rejected);
+        }
+
+    private:
+        checkpoint_store& store;
+        bool is_active = false;
+        uint64_t last_save_render_us = 0;
+        uint32_t interval_us = 0;
+
+        static size_t counts_bytes(const render_state& state) {
+            return size_t(state.tile_pixels()) * sizeof(uint16_t);
+        }
+
+        static size_t accum_bytes(const render_state& state) {
+            return size_t(state.tile_pixels()) * 3 * sizeof(float);
+        }
+
+        static uint32_t tile_offset(const render_state& state, int tile) {
+            return sizeof(checkpoint_header) + uint32_t(tile) * (8 + state.tile_bytes());
+        }
+
+        static checkpoint_header header_for(const render_state& state) {
+            checkpoint_header h;
+            memset(&h, 0, sizeof(h));
+            h.magic = CHECKPOINT_MAGIC;
+            h.version = CHECKPOINT_VERSION;
+            h.tile_size = uint16_t(state.tile_size);
+            h.width = uint16_t(state.width);
+            h.height = uint16_t(state.height);
+            h.target_spp = uint16_t(state.target_spp);
+            h.samples_per_pass = uint16_t(state.samples_per_pass);
+            h.seed = state.seed;
+            h.hash = state.hash;
+            h.tile_count = uint32_t(state.tile_count());
+            h.tile_bytes = uint32_t(8 + state.tile_bytes());
+            return h;
+        }
+
+        bool create(render_state& state) {
+            // Write the header and every tile, so each record exists at its offset from now on
+            checkpoint_header h = header_for(state);
+            uint32_t start = now_us();
+            bool ok = store.write(0, &h, sizeof(h));
+            for (int t = 0; t < state.tile_count() && ok; t++) {
+                ok = write_tile(state, t);
+                state.dirty[t] = !ok;
+            }
+            store.flush();
+            write_us += now_us() - start;
+            return ok;
+        }
+
+        bool write_tile(const render_state& state, int tile) {
+            uint32_t record[2] = { state.passes[tile], tile_crc(state, tile, state.passes[tile]) };
+            uint32_t offset = tile_offset(state, tile);
+            bool ok = store.write(offset, record, sizeof(record))
+                      && store.write(offset + 8, state.tile_counts(tile), counts_bytes(state))
+                      && store.write(offset + 8 + counts_bytes(state), state.tile_accum(tile), accum_bytes(state));
+            tiles_written++;
+            bytes_written += 8 + state.tile_bytes();
+            return ok;
+        }
+
+        static uint32_t tile_crc(const render_state& state, int tile, uint32_t passes) {
+            uint32_t crc = crc32(&passes, sizeof(passes), 0xFFFFFFFFu);
+            crc = crc32(state.tile_counts(tile), counts_bytes(state), crc);
+            crc = crc32(state.tile_accum(tile), accum_bytes(state), crc);
+            return ~crc;
+        }
+
+        static uint32_t crc32(const void* data, size_t len, uint32_t crc) {
+            // CRC-32 (IEEE, reflected), a nibble at a time
+            static const uint32_t table[16] = {
+                0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+                0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+            };
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t k = 0; k < len; k++) {
+                crc = table[(crc ^ p[k]) & 0x0F] ^ (crc >> 4);
+                crc = table[(crc ^ (p[k] >> 4)) & 0x0F] ^ (crc >> 4);
+            }
+            return crc;
+        }
+
+        static uint32_t now_us() {
+#ifdef ARDUINO
+            return micros();
+#else
+            using namespace std::chrono;
+            return uint32_t(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+};
+
+#endif
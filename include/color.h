@@ -17,7 +17,7 @@ inline float linear_to_gamma(float linear_component) {
   return 0;
 }
 
-void writeColor(int x, int y, Color pixelColor, Adafruit_ILI9341& tft) {
+uint16_t writeColor(int x, int y, Color pixelColor, Adafruit_ILI9341& tft) {
   // Apply gamma correction
   // float r = linear_to_gamma(pixelColor.x());
   // float g = linear_to_gamma(pixelColor.y());
@@ -44,6 +44,9 @@ void writeColor(int x, int y, Color pixelColor, Adafruit_ILI9341& tft) {
 
   // Write the color to the display
   tft.drawPixel(x, y, color);
+
+  // Return the 16-bit color so callers can reuse it (e.g. for frame streaming)
+  return color;
 }
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,435 @@
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <unistd.h>
+#endif
+
+// Frame streaming protocol
+//
+// Every packet on the wire looks like:
+//
+//   0xA5 0x5A | type u8 | encoding u8 | frame u16 | length u16 | payload | crc16 u16
+//
+// All integers are little endian and the CRC (CCITT, init 0xFFFF) covers
+// everything from the type byte to the end of the payload. The receiver
+// resynchronises on the two sync bytes, so a corrupt packet only loses
+// the tile it carried. See tools/frame_receiver.py for the host side.
+
+// Define the packet types
+enum frame_packet : uint8_t {
+    PACKET_FRAME_BEGIN = 1,  // payload: width u16, height u16
+    PACKET_TILE = 2,         // payload: x u16, y u16, w u16, h u16, encoded pixels
+    PACKET_FRAME_END = 3     // payload: raw u32, encoded u32, wire u32, elapsed_us u32, dropped u32
+};
+
+// Define the pixel encodings (all operate on RGB565 pixels)
+enum frame_encoding : uint8_t {
+    ENCODING_RAW = 0,     // little endian RGB565 words
+    ENCODING_RLE = 1,     // PackBits style runs and literals of RGB565 words
+    ENCODING_QOI565 = 2   // QOI style index/diff/luma/run ops adapted to 5:6:5
+};
+
+// Define the sink interface the stream writes into
+class byte_sink {
+    public:
+        virtual ~byte_sink() = default;
+
+        // Write as many bytes as fit without blocking and return the count
+        virtual size_t write_some(const uint8_t* data, size_t len) = 0;
+};
+
+#ifdef ARDUINO
+// Define the sink for the USB serial port (or any other Print)
+class serial_sink : public byte_sink {
+    public:
+        serial_sink(Print& p) : port(p) {}
+
+        virtual size_t write_some(const uint8_t* data, size_t len) override {
+            int room = port.availableForWrite();
+            if (room <= 0) {
+                return 0;
+            }
+            if (len > size_t(room)) {
+                len = size_t(room);
+            }
+            return port.write(data, len);
+        }
+
+    private:
+        Print& port;
+};
+#else
+// Define the sink for a non-blocking file descriptor (pty, pipe, tty)
+class fd_sink : public byte_sink {
+    public:
+        fd_sink(int descriptor) : fd(descriptor) {}
+
+        virtual size_t write_some(const uint8_t* data, size_t len) override {
+            ssize_t n = ::write(fd, data, len);
+            if (n < 0) {
+                return 0;
+            }
+            return size_t(n);
+        }
+
+    private:
+        int fd;
+};
+#endif
+
+// Define the per frame statistics
+struct frame_stats {
+    uint32_t raw_bytes = 0;      // size of the frame as plain RGB565
+    uint32_t encoded_bytes = 0;  // size of the encoded tile payloads
+    uint32_t wire_bytes = 0;     // everything queued, including headers and CRCs
+    uint32_t elapsed_us = 0;     // begin_frame() to end_frame()
+    uint32_t stall_us = 0;       // time spent waiting for buffer space
+    uint32_t dropped_tiles = 0;  // tiles discarded after a stall timeout
+
+    // Define the compression ratio and the wire throughput
+    float ratio() const {
+        return encoded_bytes ? float(raw_bytes) / float(encoded_bytes) : 0;
+    }
+
+    float bytes_per_second() const {
+        return elapsed_us ? float(wire_bytes) * 1e6f / float(elapsed_us) : 0;
+    }
+};
+
+// Define the frame stream class
+class frame_stream {
+    public:
+        // Define the encoding, the time a packet may wait for room while rendering
+        // (tiles that do not fit by then are dropped) and the time the final
+        // flush may block
+        frame_encoding encoding = ENCODING_QOI565;
+        uint32_t packet_timeout_us = 0;
+        uint32_t stall_timeout_us = 1000000;
+
+        // Define the statistics of the frame in flight and of the last finished one
+        frame_stats current;
+        frame_stats last_frame;
+
+        frame_stream(byte_sink& s, size_t buffer_bytes = 8192)
+            : sink(s), ring(buffer_bytes), head(0), tail(0), used(0), frame_id(0), frame_start(0) {}
+
+        void begin_frame(uint16_t width, uint16_t height) {
+            // Start a new frame and announce its size
+            current = frame_stats();
+            current.raw_bytes = uint32_t(width) * height * 2;
+            frame_start = now_us();
+
+            uint8_t payload[4];
+            put16(payload, width);
+            put16(payload + 2, height);
+            send_packet(PACKET_FRAME_BEGIN, payload, sizeof(payload));
+        }
+
+        void send_tile(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* pixels) {
+            // Encode a finished tile and queue it behind whatever is still in flight
+            size_t count = size_t(w) * h;
+            scratch.resize(8 + count * 3 + 1);
+            put16(&scratch[0], x);
+            put16(&scratch[2], y);
+            put16(&scratch[4], w);
+            put16(&scratch[6], h);
+
+            size_t encoded;
+            switch (encoding) {
+                case ENCODING_RLE:
+                    encoded = encode_rle(pixels, count, &scratch[8]);
+                    break;
+                case ENCODING_QOI565:
+                    encoded = encode_qoi565(pixels, count, &scratch[8]);
+                    break;
+                default:
+                    encoded = encode_raw(pixels, count, &scratch[8]);
+                    break;
+            }
+
+            // Tiles that would overflow the 16-bit length field go out in halves
+            if (8 + encoded > 0xFFFF) {
+                uint16_t top = h / 2;
+                if (top == 0) {
+                    current.dropped_tiles++;
+                    return;
+                }
+                send_tile(x, y, w, top, pixels);
+                send_tile(x, y + top, w, h - top, pixels + size_t(w) * top);
+                return;
+            }
+
+            if (send_packet(PACKET_TILE, scratch.data(), 8 + encoded)) {
+                current.encoded_bytes += encoded;
+            } else {
+                current.dropped_tiles++;
+            }
+        }
+
+        void end_frame() {
+            // Close the frame and report what it cost on the wire
+            current.elapsed_us = now_us() - frame_start;
+
+            uint8_t payload[20];
+            put32(payload, current.raw_bytes);
+            put32(payload + 4, current.encoded_bytes);
+            put32(payload + 8, current.wire_bytes + 8 + sizeof(payload) + 2);
+            put32(payload + 12, current.elapsed_us);
+            put32(payload + 16, current.dropped_tiles);
+            send_packet(PACKET_FRAME_END, payload, sizeof(payload), stall_timeout_us);
+
+            last_frame = current;
+            frame_id++;
+        }
+
+        void pump() {
+            // Hand the sink as much as it accepts without blocking
+            while (used > 0) {
+                size_t chunk = (tail < head) ? head - tail : ring.size() - tail;
+                size_t n = sink.write_some(&ring[tail], chunk);
+                if (n == 0) {
+                    return;
+                }
+                tail = (tail + n) % ring.size();
+                used -= n;
+            }
+        }
+
+        bool flush(uint32_t timeout_us) {
+            // Drain the buffer, giving up after the timeout
+            uint32_t start = now_us();
+            while (used > 0) {
+                pump();
+                if (now_us() - start > timeout_us) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        size_t pending() const {
+            return used;
+        }
+
+        // Define the encoders (public so that tools can measure them in isolation)
+        static size_t encode_raw(const uint16_t* px, size_t count, uint8_t* out) {
+            for (size_t i = 0; i < count; i++) {
+                put16(out + 2 * i, px[i]);
+            }
+            return count * 2;
+        }
+
+        static size_t encode_rle(const uint16_t* px, size_t count, uint8_t* out) {
+            // Control byte 0..127: that many plus one literal words follow
+            // Control byte 128..255: the next word repeats (control - 126) times
+            size_t o = 0;
+            size_t i = 0;
+            while (i < count) {
+                size_t run = 1;
+                while (i + run < count && run < 129 && px[i + run] == px[i]) {
+                    run++;
+                }
+                if (run >= 2) {
+                    out[o++] = uint8_t(126 + run);
+                    put16(out + o, px[i]);
+                    o += 2;
+                    i += run;
+                    continue;
+                }
+
+                // Collect literals until a run of two starts or the packet is full
+                size_t start = i;
+                while (i < count && i - start < 128 && !(i + 1 < count && px[i + 1] == px[i])) {
+                    i++;
+                }
+                out[o++] = uint8_t(i - start - 1);
+                for (size_t k = start; k < i; k++) {
+                    put16(out + o, px[k]);
+                    o += 2;
+                }
+            }
+            return o;
+        }
+
+        static size_t encode_qoi565(const uint16_t* px, size_t count, uint8_t* out) {
+            // 00iiiiii index, 01rrggbb diff (-2..1), 10gggggg + rrrrbbbb luma,
+            // 11nnnnnn run of 1..62, 0xFE + u16 literal. State resets every tile.
+            uint16_t index[64] = {};
+            uint16_t prev = 0;
+            size_t run = 0;
+            size_t o = 0;
+
+            for (size_t i = 0; i < count; i++) {
+                uint16_t p = px[i];
+                if (p == prev) {
+                    run++;
+                    if (run == 62 || i + 1 == count) {
+                        out[o++] = uint8_t(0xC0 | (run - 1));
+                        run = 0;
+                    }
+                    continue;
+                }
+                if (run > 0) {
+                    out[o++] = uint8_t(0xC0 | (run - 1));
+                    run = 0;
+                }
+
+                int slot = qoi565_hash(p);
+                if (index[slot] == p) {
+                    out[o++] = uint8_t(slot);
+                    prev = p;
+                    continue;
+                }
+                index[slot] = p;
+
+                // Channel differences wrap around the 5 and 6 bit channel widths
+                int dr = wrap(int(p >> 11) - int(prev >> 11), 5);
+                int dg = wrap(int((p >> 5) & 0x3F) - int((prev >> 5) & 0x3F), 6);
+                int db = wrap(int(p & 0x1F) - int(prev & 0x1F), 5);
+                int dr_dg = dr - dg;
+                int db_dg = db - dg;
+
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    out[o++] = uint8_t(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                    out[o++] = uint8_t(0x80 | (dg + 32));
+                    out[o++] = uint8_t(((dr_dg + 8) << 4) | (db_dg + 8));
+                } else {
+                    out[o++] = 0xFE;
+                    put16(out + o, p);
+                    o += 2;
+                }
+                prev = p;
+            }
+            return o;
+        }
+
+        static uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF) {
+            // CRC-16/CCITT-FALSE
+            for (size_t i = 0; i < len; i++) {
+                crc ^= uint16_t(data[i]) << 8;
+                for (int b = 0; b < 8; b++) {
+                    crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+                }
+            }
+            return crc;
+        }
+
+    private:
+        byte_sink& sink;
+        std::vector<uint8_t> ring;
+        std::vector<uint8_t> scratch;
+        size_t head, tail, used;
+        uint16_t frame_id;
+        uint32_t frame_start;
+
+        bool send_packet(uint8_t type, const uint8_t* payload, size_t len) {
+            return send_packet(type, payload, len, packet_timeout_us);
+        }
+
+        bool send_packet(uint8_t type, const uint8_t* payload, size_t len, uint32_t timeout_us) {
+            // Assemble the header, reserve room in the ring and queue the packet
+            uint8_t header[8] = { 0xA5, 0x5A, type, uint8_t(encoding), 0, 0, 0, 0 };
+            put16(header + 4, frame_id);
+            put16(header + 6, uint16_t(len));
+            uint16_t crc = crc16(header + 2, 6);
+            crc = crc16(payload, len, crc);
+            uint8_t trailer[2];
+            put16(trailer, crc);
+
+            size_t total = sizeof(header) + len + sizeof(trailer);
+            if (total > ring.size() && !grow(total, timeout_us)) {
+                return false;
+            }
+            if (!make_room(total, timeout_us)) {
+                return false;
+            }
+            push(header, sizeof(header));
+            push(payload, len);
+            push(trailer, sizeof(trailer));
+            current.wire_bytes += total;
+
+            // Start sending right away so the USB buffers fill while we render
+            pump();
+            return true;
+        }
+
+        bool grow(size_t total, uint32_t timeout_us) {
+            // Only grow an empty ring, so the queued bytes never need to move
+            if (!flush(timeout_us)) {
+                return false;
+            }
+            ring.resize(total);
+            head = tail = 0;
+            return true;
+        }
+
+        bool make_room(size_t total, uint32_t timeout_us) {
+            // Wait up to timeout_us for the packet to fit, keeping track of the stall
+            if (ring.size() - used >= total) {
+                return true;
+            }
+            uint32_t start = now_us();
+            while (ring.size() - used < total) {
+                pump();
+                if (ring.size() - used >= total) {
+                    break;
+                }
+                if (now_us() - start >= timeout_us) {
+                    current.stall_us += now_us() - start;
+                    return false;
+                }
+            }
+            current.stall_us += now_us() - start;
+            return true;
+        }
+
+        void push(const uint8_t* data, size_t len) {
+            for (size_t i = 0; i < len; i++) {
+                ring[head] = data[i];
+                head = (head + 1) % ring.size();
+            }
+            used += len;
+        }
+
+        static int qoi565_hash(uint16_t p) {
+            return ((p >> 11) * 3 + ((p >> 5) & 0x3F) * 5 + (p & 0x1F) * 7) % 64;
+        }
+
+        static int wrap(int d, int bits) {
+            // Map a channel difference into [-2^(bits-1), 2^(bits-1))
+            int range = 1 << bits;
+            d &= range - 1;
+            return d >= range / 2 ? d - range : d;
+        }
+
+        static void put16(uint8_t* out, uint16_t v) {
+            out[0] = uint8_t(v);
+            out[1] = uint8_t(v >> 8);
+        }
+
+        static void put32(uint8_t* out, uint32_t v) {
+            put16(out, uint16_t(v));
+            put16(out + 2, uint16_t(v >> 16));
+        }
+
+        static uint32_t now_us() {
+#ifdef ARDUINO
+            return micros();
+#else
+            using namespace std::chrono;
+            return uint32_t(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+        }
+};
+
+#endif
@@ -3,9 +3,11 @@
 
 #include "ray.h"
 #include "interval.h"
+#include "memory_tier.h"
 
 
 class material;
+class hittable;
 
 // Define the hit record class
 class hit_record {
@@ -20,6 +22,10 @@ class hit_record {
         bool front_face;
         std::shared_ptr<material> mat_ptr;
 
+        // Define the primitive that produced the hit (the only fields traversal sets besides t)
+        const hittable* object = nullptr;
+        uint32_t primitive = 0;  // index within object, e.g. the triangle of a mesh
+
 
         // Define the set_face_normal method
         inline void set_face_normal(const ray& r, const Vector3& outward_normal) {
@@ -35,8 +41,35 @@ class hittable {
     // Define the public methods
     public:
 
-        // Define the hit method
-        virtual bool hit(const ray& r, interval ray_t, hit_record& rec) const = 0;
+        virtual ~hittable() = default;
+
+        // Define the intersect method
+        // Finds the closest hit in ray_t and records only rec.t, rec.object and
+        // (for objects made of several primitives) rec.primitive.
+        // rec must be left untouched on a miss, so aggregates can pass the same
+        // record to every child without copying it.
+        virtual bool intersect(const ray& r, interval ray_t, hit_record& rec) const = 0;
+
+        // Define the resolve method
+        // Fills in the position, normal, face orientation and material of a hit
+        // found by intersect. Only called once, on the closest primitive.
+        virtual void resolve(const ray& /*r*/, hit_record& /*rec*/) const {}
+
+        // Define the hit method (closest hit first, attributes afterwards)
+        bool hit(const ray& r, interval ray_t, hit_record& rec) const {
+            if (!intersect(r, ray_t, rec)) {
+                return false;
+            }
+            rec.object->resolve(r, rec);
+            return true;
+        }
+
+        // Define the eager hit method
+        // Reference for the benchmarks: one call per candidate that fills in every
+        // attribute as soon as the hit is found, as hit() did before resolve().
+        virtual bool hit_eager(const ray& r, interval ray_t, hit_record& rec) const {
+            return hit(r, ray_t, rec);
+        }
 };
 
 
@@ -19,21 +19,20 @@ class hittable_list : public hittable {
         // Define the clear, add, and hit methods
         void clear() { objects.clear(); }
         void add(shared_ptr<hittable> object) { objects.push_back(object); }
+        void reserve(size_t count) { objects.reserve(count); }
 
-        // Define the hit method
-        virtual bool hit(const ray& r, interval ray_t, hit_record& rec) const override {
+        // Define the intersect method
+        RT_HOT virtual bool intersect(const ray& r, interval ray_t, hit_record& rec) const override {
             
-            // Define the temporary hit record and the hit anything flag
-            hit_record temp_rec;
+            // Define the hit anything flag
             bool hit_anything = false;
             auto closest_so_far = ray_t.max;
 
-            // Loop through the objects in the list
+            // Loop through the objects in the list (children only write rec on a closer hit)
             for (const auto& object : objects) {
-                if (object->hit(r, interval(ray_t.min, closest_so_far), temp_rec)) {
+                if (object->intersect(r, interval(ray_t.min, closest_so_far), rec)) {
                     hit_anything = true;
-                    closest_so_far = temp_rec.t;
-                    rec = temp_rec;
+                    closest_so_far = rec.t;
                 }
             }
 
@@ -41,8 +40,8 @@ class hittable_list : public hittable {
             return hit_anything;
         }
     public:
-        // Define the objects vector
-        std::vector<shared_ptr<hittable>> objects;
+        // Define the objects vector (placed in the scene arena with the objects)
+        std::vector<shared_ptr<hittable>, tier_allocator<shared_ptr<hittable>>> objects;
 };
 
 #endif
\ No newline at end of file
@@ -5,12 +5,24 @@
 
 class hit_record;
 
+// Define the material kinds (used to sort rays by material without RTTI)
+enum material_kind : uint8_t {
+    MATERIAL_LAMBERTIAN = 0,
+    MATERIAL_METAL = 1,
+    MATERIAL_DIELECTRIC = 2,
+    MATERIAL_OTHER = 3,
+    MATERIAL_KIND_COUNT = 4
+};
+
 // Define the material class
 class material {
 
     // Define the public methods
     public:
 
+        // Define the kind of the material
+        material_kind kind = MATERIAL_OTHER;
+
         // Define the scatter method
         virtual ~material() = default;
         virtual bool scatter(const ray& r_in, const hit_record& rec, Color& attenuation, ray& scattered) const = 0;
@@ -21,7 +33,7 @@ class lambertian : public material {
     public:
 
         // Define the lambertian constructor
-        lambertian(const Color& a) : albedo(a) {}
+        lambertian(const Color& a) : albedo(a) { kind = MATERIAL_LAMBERTIAN; }
 
         // Define the scatter method
         virtual bool scatter(const ray& r_in, const hit_record& rec, Color& attenuation, ray& scattered) const override {
@@ -49,7 +61,7 @@ class metal : public material {
     public:
 
         // Define the metal constructor
-        metal(const Color& a, float f) : albedo(a), fuzz(f < 1 ? f : 1) {}
+        metal(const Color& a, float f) : albedo(a), fuzz(f < 1 ? f : 1) { kind = MATERIAL_METAL; }
 
         // Define the scatter method
         virtual bool scatter(const ray& r_in, const hit_record& rec, Color& attenuation, ray& scattered) const override {
@@ -71,7 +83,7 @@ class dielectric : public material {
     public:
 
         // Define the dielectric constructor
-        dielectric(float index_of_refraction) : ir(index_of_refraction) {}
+        dielectric(float index_of_refraction) : ir(index_of_refraction) { kind = MATERIAL_DIELECTRIC; }
 
         // Define the scatter method
         virtual bool scatter(const ray& r_in, const hit_record& rec, Color& attenuation, ray& scattered) const override {
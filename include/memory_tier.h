@@ -0,0 +1,275 @@
+#ifndef MEMORY_TIER_H
+#define MEMORY_TIER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <memory>
+
+// Memory tier placement
+//
+// The Teensy 4.1 has four places for data: DTCM (tightly coupled, zero
+// wait states), OCRAM (DMAMEM, behind the cache), optional PSRAM (EXTMEM,
+// slow) and the heap, which lives in OCRAM. Scene objects created with
+// make_placed<T>() are bump allocated from a DTCM pool first and spill to
+// an OCRAM pool, then PSRAM, then the heap. Hot kernels are tagged RT_HOT
+// so they are linked into ITCM. Define RT_NO_PLACEMENT to turn all of it
+// off and compare.
+
+// Define fallbacks for builds without the Teensy section macros
+#ifndef FASTRUN
+#define FASTRUN
+#endif
+#ifndef DMAMEM
+#define DMAMEM
+#endif
+#ifndef EXTMEM
+#define EXTMEM
+#endif
+
+// Define the attribute for hot kernels
+#ifdef RT_NO_PLACEMENT
+#define RT_HOT
+#else
+#define RT_HOT FASTRUN
+#endif
+
+// Define the sizes of the bump pools
+#ifndef RT_DTCM_POOL_BYTES
+#define RT_DTCM_POOL_BYTES 65536
+#endif
+#ifndef RT_OCRAM_POOL_BYTES
+#define RT_OCRAM_POOL_BYTES 65536
+#endif
+
+// Define the memory tiers in order of preference
+enum memory_tier : uint8_t {
+    TIER_DTCM = 0,
+    TIER_OCRAM = 1,
+    TIER_PSRAM = 2,
+    TIER_HEAP = 3,
+    TIER_COUNT = 4
+};
+
+#ifndef RT_NO_PLACEMENT
+// Define the bump pools (DTCM is the default for static data on Teensy 4); function
+// statics of inline functions, so every translation unit shares the same pools
+inline uint8_t* rt_dtcm_pool() {
+    static uint8_t pool[RT_DTCM_POOL_BYTES] __attribute__((aligned(32)));
+    return pool;
+}
+
+inline uint8_t* rt_ocram_pool() {
+    DMAMEM static uint8_t pool[RT_OCRAM_POOL_BYTES] __attribute__((aligned(32)));
+    return pool;
+}
+#endif
+
+// Define the tiered arena class
+class tier_arena {
+    public:
+        // Define the bytes held per tier (for the pools: up to the bump top)
+        size_t used[TIER_COUNT] = {};
+        size_t requests[TIER_COUNT] = {};
+
+        void* allocate(size_t bytes, size_t align) {
+            // Try each tier in order until one has room
+            (void)align;
+#ifndef RT_NO_PLACEMENT
+            void* p = bump(rt_dtcm_pool(), RT_DTCM_POOL_BYTES, dtcm_top, bytes, align);
+            if (p) {
+                return account_pool(TIER_DTCM, dtcm_top, p);
+            }
+            p = bump(rt_ocram_pool(), RT_OCRAM_POOL_BYTES, ocram_top, bytes, align);
+            if (p) {
+                return account_pool(TIER_OCRAM, ocram_top, p);
+            }
+#endif
+#ifdef ARDUINO_TEENSY41
+            if (external_psram_size > 0) {
+                void* ext = extmem_malloc(bytes);
+                if (ext) {
+                    return account(TIER_PSRAM, bytes, ext);
+                }
+            }
+#endif
+            return account(TIER_HEAP, bytes, malloc(bytes));
+        }
+
+        void deallocate(void* p, size_t bytes) {
+            // The pools take back the block on top (LIFO frees); anything below it stays
+            // held until reset(). The rest goes back to its allocator
+            memory_tier tier = tier_of(p);
+#ifndef RT_NO_PLACEMENT
+            if (tier == TIER_DTCM) {
+                used[tier] = release(rt_dtcm_pool(), dtcm_top, p, bytes);
+                return;
+            }
+            if (tier == TIER_OCRAM) {
+                used[tier] = release(rt_ocram_pool(), ocram_top, p, bytes);
+                return;
+            }
+#endif
+            used[tier] -= bytes;
+            if (tier == TIER_PSRAM) {
+#ifdef ARDUINO_TEENSY41
+                extmem_free(p);
+#endif
+            } else if (tier == TIER_HEAP) {
+                free(p);
+            }
+        }
+
+        void reset() {
+            // Forget everything in the pools (only safe once the scene is gone)
+            dtcm_top = ocram_top = 0;
+            used[TIER_DTCM] = used[TIER_OCRAM] = 0;
+        }
+
+        memory_tier tier_of(const void* p) const {
+            // Find the tier an address belongs to
+            uintptr_t a = uintptr_t(p);
+#ifndef RT_NO_PLACEMENT
+            if (a >= uintptr_t(rt_dtcm_pool()) && a < uintptr_t(rt_dtcm_pool()) + RT_DTCM_POOL_BYTES) {
+                return TIER_DTCM;
+            }
+            if (a >= uintptr_t(rt_ocram_pool()) && a < uintptr_t(rt_ocram_pool()) + RT_OCRAM_POOL_BYTES) {
+                return TIER_OCRAM;
+            }
+#endif
+#ifdef ARDUINO_TEENSY41
+            if (a >= 0x70000000 && a < 0x71000000) {
+                return TIER_PSRAM;
+            }
+#endif
+            (void)a;
+            return TIER_HEAP;
+        }
+
+        size_t capacity(memory_tier tier) const {
+            (void)tier;
+#ifndef RT_NO_PLACEMENT
+            if (tier == TIER_DTCM) return RT_DTCM_POOL_BYTES;
+            if (tier == TIER_OCRAM) return RT_OCRAM_POOL_BYTES;
+#endif
+#ifdef ARDUINO_TEENSY41
+            if (tier == TIER_PSRAM) return size_t(external_psram_size) << 20;
+#endif
+            return 0;
+        }
+
+    private:
+        size_t dtcm_top = 0;
+        size_t ocram_top = 0;
+
+        static void* bump(uint8_t* pool, size_t size, size_t& top, size_t bytes, size_t align) {
+            size_t start = (top + align - 1) & ~(align - 1);
+            if (start + bytes > size) {
+                return nullptr;
+            }
+            top = start + bytes;
+            return pool + start;
+        }
+
+        static size_t release(uint8_t* pool, size_t& top, void* p, size_t bytes) {
+            // Lower the top if p is the last block handed out; returns the bytes still held
+            if (static_cast<uint8_t*>(p) + bytes == pool + top) {
+                top = size_t(static_cast<uint8_t*>(p) - pool);
+            }
+            return top;
+        }
+
+        void* account(memory_tier tier, size_t bytes, void* p) {
+            if (p) {
+                used[tier] += bytes;
+                requests[tier]++;
+            }
+            return p;
+        }
+
+        void* account_pool(memory_tier tier, size_t top, void* p) {
+            // Pool tiers report their top, which includes alignment and blocks freed out of order
+            used[tier] = top;
+            requests[tier]++;
+            return p;
+        }
+};
+
+// Define the arena the scene is placed in
+inline tier_arena& scene_arena() {
+    static tier_arena arena;
+    return arena;
+}
+
+// Define the standard allocator on top of the scene arena
+template <class T>
+struct tier_allocator {
+    using value_type = T;
+
+    tier_allocator() = default;
+    template <class U> tier_allocator(const tier_allocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(scene_arena().allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        scene_arena().deallocate(p, n * sizeof(T));
+    }
+
+    template <class U> bool operator==(const tier_allocator<U>&) const { return true; }
+    template <class U> bool operator!=(const tier_allocator<U>&) const { return false; }
+};
+
+// Define the factory for scene objects (object and control block share one allocation)
+template <class T, class... Args>
+std::shared_ptr<T> make_placed(Args&&... args) {
+#ifdef RT_NO_PLACEMENT
+    return std::make_shared<T>(std::forward<Args>(args)...);
+#else
+    return std::allocate_shared<T>(tier_allocator<T>(), std::forward<Args>(args)...);
+#endif
+}
+
+#if defined(__IMXRT1062__)
+// Define the linker symbols of the Teensy 4.x memory layout
+extern "C" {
+    extern unsigned long _stext, _etext, _sdata, _edata, _sbss, _ebss;
+    extern unsigned long _heap_start, _heap_end, _flashimagelen, _itcm_block_count;
+    extern unsigned long _extram_start, _extram_end;
+    void* sbrk(int incr);
+}
+#endif
+
+inline void print_memory_map(Print& out) {
+    // Report the bytes in each region and where the scene landed
+#if defined(__IMXRT1062__)
+    uint32_t itcm_size = uint32_t(&_itcm_block_count) * 32768;
+    uint32_t itcm_used = uint32_t(&_etext) - uint32_t(&_stext);
+    uint32_t dtcm_size = 512 * 1024 - itcm_size;
+    uint32_t dtcm_used = uint32_t(&_ebss) - uint32_t(&_sdata);
+    uint32_t dmamem_used = uint32_t(&_heap_start) - 0x20200000;
+    uint32_t heap_used = uint32_t(sbrk(0)) - uint32_t(&_heap_start);
+    uint32_t heap_size = uint32_t(&_heap_end) - uint32_t(&_heap_start);
+
+    out.printf("memory: flash  %7lu bytes image\n", (unsigned long)uint32_t(&_flashimagelen));
+    out.printf("memory: ITCM   %7lu / %7lu bytes code (FASTRUN)\n", (unsigned long)itcm_used, (unsigned long)itcm_size);
+    out.printf("memory: DTCM   %7lu / %7lu bytes data+bss, rest is stack\n", (unsigned long)dtcm_used, (unsigned long)dtcm_size);
+    out.printf("memory: OCRAM  %7lu bytes DMAMEM, heap %lu / %lu bytes\n",
+               (unsigned long)dmamem_used, (unsigned long)heap_used, (unsigned long)heap_size);
+#ifdef ARDUINO_TEENSY41
+    out.printf("memory: PSRAM  %7lu bytes EXTMEM of %u MB\n",
+               (unsigned long)(uint32_t(&_extram_end) - uint32_t(&_extram_start)), (unsigned)external_psram_size);
+#endif
+#endif
+
+    static const char* names[TIER_COUNT] = { "DTCM", "OCRAM", "PSRAM", "heap" };
+    const tier_arena& arena = scene_arena();
+    for (int t = 0; t < TIER_COUNT; t++) {
+        out.printf("memory: scene in %-5s %7lu bytes in %4lu objects (pool %lu)\n", names[t],
+                   (unsigned long)arena.used[t], (unsigned long)arena.requests[t],
+                   (unsigned long)arena.capacity(memory_tier(t)));
+    }
+}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef RADIANCE_CACHE_H
+#define RADIANCE_CACHE_H
+
+#include "vec3.h"
+#include "color.h"
+#include "memory_tier.h"
+#include <cmath>
+#include <vector>
+
+// Radiance cache
+//
+// Stores the mean incoming radiance over the cosine-weighted hemisphere
+// (irradiance / pi) at sparse points on diffuse surfaces, so that
+// secondary diffuse bounces can interpolate it instead of tracing further.
+// Records live in a fixed-size pool indexed by a spatial hash of grid
+// cells; once the pool is full, bounces that no record covers are traced
+// as usual, so memory stays bounded.
+//
+// Interpolation follows Ward's irradiance caching: record i contributes to
+// point p with normal n when
+//
+//   w_i = 1 / (|p - p_i| / R_i + sqrt(1 - n . n_i)) > 1 / max_error
+//
+// where R_i is the harmonic mean distance to the surfaces the record saw.
+// Smaller max_error means denser records and less bias.
+
+// Define a cache record
+struct radiance_record {
+    point3 p;
+    Vector3 n;
+    Color value;                   // mean incoming radiance (irradiance / pi)
+    Vector3 grad_r, grad_g, grad_b; // translational gradient of each channel
+    float radius;                  // validity radius R_i
+};
+
+// Define a link of a hash bucket's record list
+struct radiance_link {
+    int32_t record;
+    int32_t next;                  // next link in the same bucket
+};
+
+// Define the radiance cache class
+class radiance_cache {
+    public:
+        // Define the tuning knobs
+        float max_error = 0.5;    // Ward's a: larger is faster and blurrier (at most 1, see lookup)
+        float min_radius = 0.05;  // clamp for R_i in world units
+        float max_radius = 1.0;   // clamp for R_i, also the hash cell size
+        int samples = 16;         // hemisphere rays per new record
+
+        // Define the statistics
+        uint32_t lookups = 0;
+        uint32_t hits = 0;
+        uint32_t inserted = 0;
+        uint32_t rejected = 0;    // misses traced normally because the pool was full
+
+        // Set while a record is being computed: rays traced for it bypass the cache
+        bool busy = false;
+
+        radiance_cache(int max_records, int bucket_count = 1024) {
+            // Allocate the pool and the hash table once, up front
+            records.reserve(max_records);
+            links.reserve(size_t(max_records) * 8);
+            int b = 1;
+            while (b < bucket_count) {
+                b <<= 1;
+            }
+            heads.assign(b, -1);
+        }
+
+        void clear() {
+            records.clear();
+            links.clear();
+            for (auto& h : heads) {
+                h = -1;
+            }
+            lookups = hits = inserted = rejected = 0;
+        }
+
+        size_t size() const { return records.size(); }
+        size_t capacity() const { return records.capacity(); }
+        bool full() const { return records.size() >= records.capacity(); }
+
+        size_t bytes() const {
+            return records.capacity() * sizeof(radiance_record) + links.capacity() * sizeof(radiance_link)
+                   + heads.size() * sizeof(int32_t);
+        }
+
+        bool lookup(const point3& p, const Vector3& n, Color& out) {
+            // Interpolate the records that are valid at (p, n)
+            lookups++;
+            int cx, cy, cz;
+            cell_of(p, cx, cy, cz);
+
+            // A record is valid within max_error * radius of its point and is linked into
+            // every cell that sphere touches, so the cell of p holds every candidate
+            float a = fmin(max_error, 1.0f);
+            float weight_sum = 0;
+            Color sum(0, 0, 0);
+            for (int32_t k = heads[bucket(cx, cy, cz)]; k >= 0; k = links[k].next) {
+                const radiance_record& rec = records[links[k].record];
+                Vector3 d = p - rec.p;
+                float reach = a * rec.radius;
+                float distance_squared = d.length_squared();
+                if (distance_squared >= reach * reach) {
+                    continue;
+                }
+                float cos_n = dot(n, rec.n);
+                if (cos_n <= 0) {
+                    continue;
+                }
+
+                // Skip records in front of p (they see a different neighbourhood)
+                if (dot(d, n + rec.n) < -0.1f * rec.radius) {
+                    continue;
+                }
+
+                float denom = std::sqrt(distance_squared) / rec.radius + std::sqrt(fmax(0.0f, 1.0f - cos_n));
+                float w = denom > 1e-6f ? 1.0f / denom : 1e6f;
+                if (w * a <= 1.0f) {
+                    continue;
+                }
+
+                // Extrapolate with the gradient, never below zero
+                Color v(fmax(0.0f, rec.value[0] + dot(rec.grad_r, d)),
+                        fmax(0.0f, rec.value[1] + dot(rec.grad_g, d)),
+                        fmax(0.0f, rec.value[2] + dot(rec.grad_b, d)));
+                sum += w * v;
+                weight_sum += w;
+            }
+
+            if (weight_sum <= 0) {
+                return false;
+            }
+            out = sum / weight_sum;
+            hits++;
+            return true;
+        }
+
+        void insert(const point3& p, const Vector3& n, const Color& value,
+                    const Vector3& grad_r, const Vector3& grad_g, const Vector3& grad_b, float radius) {
+            // Store a record, or count it as rejected once the pool is full
+            if (full()) {
+                rejected++;
+                return;
+            }
+            radiance_record rec;
+            rec.p = p;
+            rec.n = n;
+            rec.value = value;
+            rec.grad_r = grad_r;
+            rec.grad_g = grad_g;
+            rec.grad_b = grad_b;
+            rec.radius = fmin(fmax(radius, min_radius), max_radius);
+            int32_t index = int32_t(records.size());
+            records.push_back(rec);
+            inserted++;
+
+            // Link the record into every cell its sphere of validity touches (at most two
+            // per axis, since the reach is at most one cell wide), once per bucket
+            float reach = fmin(max_error, 1.0f) * rec.radius;
+            int lo[3], hi[3];
+            cell_of(p - Vector3(reach, reach, reach), lo[0], lo[1], lo[2]);
+            cell_of(p + Vector3(reach, reach, reach), hi[0], hi[1], hi[2]);
+            int buckets[8];
+            int bucket_count = 0;
+            for (int z = lo[2]; z <= hi[2]; z++) {
+                for (int y = lo[1]; y <= hi[1]; y++) {
+                    for (int x = lo[0]; x <= hi[0]; x++) {
+                        int b = bucket(x, y, z);
+                        bool seen = false;
+                        for (int k = 0; k < bucket_count && !seen; k++) {
+                            seen = buckets[k] == b;
+                        }
+                        if (!seen && bucket_count < 8) {
+                            buckets[bucket_count++] = b;
+                            links.push_back({ index, heads[b] });
+                            heads[b] = int32_t(links.size() - 1);
+                        }
+                    }
+                }
+            }
+        }
+
+        void print(Print& out) const {
+            out.printf("cache: %u / %u records (%lu bytes), %lu lookups, %.1f%% hits, %lu rejected\n",
+                       (unsigned)records.size(), (unsigned)records.capacity(), (unsigned long)bytes(),
+                       (unsigned long)lookups, lookups ? 100.0f * hits / lookups : 0.0f,
+                       (unsigned long)rejected);
+        }
+
+    private:
+        std::vector<radiance_record, tier_allocator<radiance_record>> records;
+        std::vector<radiance_link, tier_allocator<radiance_link>> links;
+        std::vector<int32_t, tier_allocator<int32_t>> heads;
+
+        void cell_of(const point3& p, int& x, int& y, int& z) const {
+            // Cells are max_radius wide, the largest reach of a record
+            x = int(std::floor(p[0] / max_radius));
+            y = int(std::floor(p[1] / max_radius));
+            z = int(std::floor(p[2] / max_radius));
+        }
+
+        int bucket(int x, int y, int z) const {
+            uint32_t h = uint32_t(x) * 73856093u ^ uint32_t(y) * 19349663u ^ uint32_t(z) * 83492791u;
+            return int(h & uint32_t(heads.size() - 1));
+        }
+};
+
+#endif
@@ -17,6 +17,7 @@
 #include "hittable.h"
 #include "hittable_list.h"
 #include "sphere.h"
+#include "triangle_mesh.h"
 #include "interval.h"
 
 // Useful stuff from C++ Standard Library
@@ -0,0 +1,135 @@
+#ifndef RENDER_BUDGET_H
+#define RENDER_BUDGET_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Define one scheduling decision (taken before each row)
+struct budget_decision {
+    int16_t row;
+    uint16_t spp;
+    uint8_t depth;
+    uint32_t elapsed_us;  // time since the render started when the row began
+};
+
+// Define the deadline driven sample scheduler
+//
+// The scheduler measures the cost of a camera sample online and, before
+// every row, spreads the time that is left over the pixels that are left.
+// When even one sample per pixel does not fit it lowers the depth cap
+// instead, and raises it again once there is slack. Rows are visited in an
+// interleaved order so that early and late decisions are spread over the
+// whole image instead of producing a sharp top and a noisy bottom.
+class render_budget {
+    public:
+        // Define the tuning knobs
+        float safety = 0.03;     // fraction of the budget held back for the final flush
+        float smoothing = 0.25;  // weight of the newest row in the cost estimate
+
+        // Define the outcome of the last render
+        uint32_t target_us = 0;
+        uint32_t actual_us = 0;
+        uint32_t total_samples = 0;
+        float cost_per_sample_us = 0;
+        std::vector<budget_decision> decisions;
+
+        void begin(uint32_t budget_us, int spp_cap, int depth_cap, int height, float total_weight) {
+            // Reset the scheduler for a new frame (total_weight is the number of
+            // pixels, or the sum of their rates when a sample_map is in use)
+            target_us = budget_us;
+            max_spp = spp_cap > 0 ? spp_cap : 1;
+            max_depth = depth_cap > 0 ? depth_cap : 1;
+            depth = max_depth;
+            spp = 1;
+            weight_left = total_weight;
+            total_samples = 0;
+            cost_per_sample_us = 0;
+            decisions.clear();
+            decisions.reserve(height);
+            start = micros();
+            row_start = start;
+        }
+
+        void plan_row(int row) {
+            // Choose spp and depth for the next row from the time that is left
+            uint32_t now = micros();
+            row_start = now;
+            uint32_t elapsed = now - start;
+            float usable = float(target_us) * (1.0f - safety);
+            float remaining = usable > float(elapsed) ? usable - float(elapsed) : 0.0f;
+
+            // Stay at one sample and full depth until there is a measurement
+            if (cost_per_sample_us > 0) {
+                float fit = weight_left > 0 ? remaining / (weight_left * cost_per_sample_us) : float(max_spp);
+
+                if (fit < 1.0f) {
+                    // Not even one full depth sample per pixel fits: cut depth
+                    spp = 1;
+                    int cut = int(depth * fit);
+                    depth = cut < 1 ? 1 : cut;
+                } else if (fit >= 2.0f && depth < max_depth) {
+                    // Plenty of slack: give depth back before adding samples
+                    int grow = int(depth * 2);
+                    depth = grow > max_depth ? max_depth : grow;
+                    spp = 1;
+                } else {
+                    spp = int(fit);
+                    if (spp > max_spp) {
+                        spp = max_spp;
+                    }
+                }
+            }
+
+            decisions.push_back({ int16_t(row), uint16_t(spp), uint8_t(depth), elapsed });
+        }
+
+        void finish_row(float row_weight, uint32_t samples) {
+            // Fold the cost of the finished row into the estimate
+            uint32_t row_us = micros() - row_start;
+            if (samples > 0) {
+                float measured = float(row_us) / samples;
+                cost_per_sample_us = cost_per_sample_us > 0
+                    ? smoothing * measured + (1.0f - smoothing) * cost_per_sample_us
+                    : measured;
+            }
+            total_samples += samples;
+            weight_left -= row_weight;
+        }
+
+        void end() {
+            actual_us = micros() - start;
+        }
+
+        int samples() const { return spp; }
+        int depth_cap() const { return depth; }
+
+        void print(Print& out) const {
+            // Report target vs. actual time and a summary of the decisions
+            int min_spp = max_spp, top_spp = 0, min_depth = max_depth;
+            for (const auto& d : decisions) {
+                if (d.spp < min_spp) min_spp = d.spp;
+                if (d.spp > top_spp) top_spp = d.spp;
+                if (d.depth < min_depth) min_depth = d.depth;
+            }
+            out.printf("budget: target %lu us, actual %lu us (%.1f%%)\n",
+                       (unsigned long)target_us, (unsigned long)actual_us,
+                       target_us ? 100.0f * actual_us / target_us : 0.0f);
+            out.printf("budget: %lu samples, %.2f us/sample, spp %d..%d, depth >= %d\n",
+                       (unsigned long)total_samples, cost_per_sample_us, min_spp, top_spp, min_depth);
+            for (const auto& d : decisions) {
+                out.printf("budget: row %d at %lu us -> spp %u depth %u\n",
+                           d.row, (unsigned long)d.elapsed_us, d.spp, d.depth);
+            }
+        }
+
+    private:
+        int max_spp = 1;
+        int max_depth = 1;
+        int spp = 1;
+        int depth = 1;
+        float weight_left = 0;
+        uint32_t start = 0;
+        uint32_t row_start = 0;
+};
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "memory_tier.h"
+
+// Resumable render state
+//
+// A progressive render keeps everything it needs to continue in one
+// render_state: the accumulated radiance and the sample count of every
+// pixel, the number of passes each tile has taken and the hash of the
+// scene and camera it belongs to. The frame is cut into square tiles
+// and stored tile by tile, so a tile is one contiguous block that
+// render_checkpoint can write out on its own.
+//
+// A pass adds samples_per_pass samples to every pixel of one tile. Each
+// (tile, pass) reseeds the random number generator from the seed, so the
+// pass count doubles as the position in that tile's random stream: a
+// render resumed from a checkpoint gives the same image as one that was
+// never interrupted (except with a radiance cache, whose contents are lost).
+
+// Define the default tile edge in pixels
+#ifndef RT_TILE_SIZE
+#define RT_TILE_SIZE 16
+#endif
+
+// Define the render state class
+class render_state {
+    public:
+        // Define the frame and its sampling plan
+        int width = 0;
+        int height = 0;
+        int tile_size = RT_TILE_SIZE;
+        int tiles_x = 0;
+        int tiles_y = 0;
+        int target_spp = 0;
+        int samples_per_pass = 0;
+        uint32_t seed = 0;
+        uint32_t hash = 0;        // scene and camera fingerprint (see camera::fingerprint)
+
+        // Define the per tile progress
+        std::vector<uint32_t, tier_allocator<uint32_t>> passes;
+        std::vector<uint8_t, tier_allocator<uint8_t>> dirty;  // changed since the last checkpoint
+
+        // Define the render time spent on this state since boot
+        uint64_t render_us = 0;
+
+        bool begin(int w, int h, int spp, int per_pass, uint32_t scene_hash, uint32_t random_seed = 1) {
+            // Size the state for a w x h frame and clear it; returns false if it does not fit in memory
+            width = w;
+            height = h;
+            tiles_x = (w + tile_size - 1) / tile_size;
+            tiles_y = (h + tile_size - 1) / tile_size;
+            target_spp = spp < 1 ? 1 : spp;
+            samples_per_pass = per_pass < 1 ? 1 : (per_pass > target_spp ? target_spp : per_pass);
+            seed = random_seed;
+            hash = scene_hash;
+
+            // Both pixel buffers share one block, too large for the pools, so it lands in
+            // PSRAM when fitted; a begin() for another frame size replaces it
+            size_t bytes = pixels() * (3 * sizeof(float) + sizeof(uint16_t));
+            if (bytes != block_bytes) {
+                release();
+                block = static_cast<uint8_t*>(scene_arena().allocate(bytes, 4));
+                if (!block) {
+                    return false;
+                }
+                block_bytes = bytes;
+                accum = reinterpret_cast<float*>(block);
+                counts = reinterpret_cast<uint16_t*>(block + pixels() * 3 * sizeof(float));
+            }
+            passes.assign(tile_count(), 0);
+            dirty.assign(tile_count(), 0);
+            memset(accum, 0, pixels() * 3 * sizeof(float));
+            memset(counts, 0, pixels() * sizeof(uint16_t));
+            render_us = 0;
+            return true;
+        }
+
+        ~render_state() {
+            release();
+        }
+
+        render_state() = default;
+        render_state(const render_state&) = delete;
+        render_state& operator=(const render_state&) = delete;
+
+        bool ready() const { return block != nullptr; }
+        int tile_count() const { return tiles_x * tiles_y; }
+        int tile_pixels() const { return tile_size * tile_size; }
+        size_t pixels() const { return size_t(tiles_x) * tiles_y * tile_pixels(); }
+
+        size_t tile_bytes() const {
+            // Bytes of pixel state per tile (sample counts and accumulated radiance)
+            return size_t(tile_pixels()) * (sizeof(uint16_t) + 3 * sizeof(float));
+        }
+
+        int total_passes() const {
+            return (target_spp + samples_per_pass - 1) / samples_per_pass;
+        }
+
+        int pass_samples(uint32_t pass) const {
+            // Samples per pixel of the given pass (the last one takes the remainder)
+            int rest = target_spp - int(pass) * samples_per_pass;
+            return rest < samples_per_pass ? rest : samples_per_pass;
+        }
+
+        int next_tile() const {
+            // Returns the unfinished tile with the fewest passes, or -1 when done,
+            // so the whole frame refines together
+            int best = -1;
+            for (int t = 0; t < tile_count(); t++) {
+                if (int(passes[t]) < total_passes() && (best < 0 || passes[t] < passes[best])) {
+                    best = t;
+                }
+            }
+            return best;
+        }
+
+        bool done() const {
+            return ready() && next_tile() < 0;
+        }
+
+        uint32_t stream_seed(int tile, uint32_t pass) const {
+            // Seed of the random stream for one (tile, pass)
+            uint32_t h = seed ^ (uint32_t(tile) * 0x9E3779B1u) ^ (pass * 0x85EBCA77u);
+            h ^= h >> 16;
+            h *= 0x7FEB352Du;
+            h ^= h >> 15;
+            h *= 0x846CA68Bu;
+            h ^= h >> 16;
+            return h;
+        }
+
+        void tile_origin(int tile, int& x0, int& y0) const {
+            x0 = (tile % tiles_x) * tile_size;
+            y0 = (tile / tiles_x) * tile_size;
+        }
+
+        float* tile_accum(int tile) { return accum + size_t(tile) * tile_pixels() * 3; }
+        const float* tile_accum(int tile) const { return accum + size_t(tile) * tile_pixels() * 3; }
+        uint16_t* tile_counts(int tile) { return counts + size_t(tile) * tile_pixels(); }
+        const uint16_t* tile_counts(int tile) const { return counts + size_t(tile) * tile_pixels(); }
+
+        void clear_tile(int tile) {
+            passes[tile] = 0;
+            memset(tile_accum(tile), 0, size_t(tile_pixels()) * 3 * sizeof(float));
+            memset(tile_counts(tile), 0, size_t(tile_pixels()) * sizeof(uint16_t));
+        }
+
+        uint32_t passes_done() const {
+            uint32_t sum = 0;
+            for (uint32_t p : passes) {
+                sum += p;
+            }
+            return sum;
+        }
+
+        void print(Print& out) const {
+            out.printf("state: %dx%d in %d tiles of %d, %lu / %lu passes of %d spp, %.1f s rendering, %lu bytes\n",
+                       width, height, tile_count(), tile_size, (unsigned long)passes_done(),
+                       (unsigned long)tile_count() * total_passes(), samples_per_pass, render_us * 1e-6,
+                       (unsigned long)(pixels() * (3 * sizeof(float) + sizeof(uint16_t))));
+        }
+
+    private:
+        uint8_t* block = nullptr;    // accum followed by counts
+        size_t block_bytes = 0;
+        float* accum = nullptr;      // tile by tile, RGB per pixel
+        uint16_t* counts = nullptr;  // tile by tile, samples per pixel
+
+        void release() {
+            if (block) {
+                scene_arena().deallocate(block, block_bytes);
+            }
+            block = nullptr;
+            block_bytes = 0;
+            accum = nullptr;
+            counts = nullptr;
+        }
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef SAMPLE_MAP_H
+#define SAMPLE_MAP_H
+
+#include <stdint.h>
+#include <cmath>
+
+// Define the shapes a sampling-rate map can take
+enum sample_shape : uint8_t {
+    SAMPLE_UNIFORM = 0,  // every pixel at full rate
+    SAMPLE_RECT = 1,     // full rate inside a rectangle, outside_rate elsewhere
+    SAMPLE_RADIAL = 2,   // full rate inside inner_radius, falling to outside_rate at outer_radius
+    SAMPLE_MASK = 3      // low-res mask (255 = full rate) stretched over the frame
+};
+
+// Define the sampling-rate map class
+//
+// A map assigns every pixel a rate in [outside_rate, 1] which scales the
+// camera's samples per pixel (and, optionally, its depth cap). Independently
+// of the shape, a crop rectangle can exclude pixels from the render entirely.
+class sample_map {
+    public:
+        // Define the shape and its parameters (pixel coordinates)
+        sample_shape shape = SAMPLE_UNIFORM;
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;       // SAMPLE_RECT, half-open
+        float cx = 0, cy = 0;                       // SAMPLE_RADIAL
+        float inner_radius = 0, outer_radius = 0;   // SAMPLE_RADIAL
+        const uint8_t* mask = nullptr;              // SAMPLE_MASK, row major
+        int mask_width = 0, mask_height = 0;        // SAMPLE_MASK
+
+        // Define the rate outside the region of interest and whether depth follows the rate
+        float outside_rate = 0.05;
+        bool scale_depth = true;
+
+        // Define the crop rectangle (half-open, disabled when empty)
+        int crop_x0 = 0, crop_y0 = 0, crop_x1 = 0, crop_y1 = 0;
+
+        void set_rect(int left, int top, int right, int bottom, float rate_outside) {
+            shape = SAMPLE_RECT;
+            x0 = left; y0 = top; x1 = right; y1 = bottom;
+            outside_rate = rate_outside;
+        }
+
+        void set_radial(float center_x, float center_y, float inner, float outer, float rate_outside) {
+            shape = SAMPLE_RADIAL;
+            cx = center_x; cy = center_y;
+            inner_radius = inner; outer_radius = outer > inner ? outer : inner;
+            outside_rate = rate_outside;
+        }
+
+        void set_mask(const uint8_t* values, int width, int height, float rate_floor) {
+            shape = SAMPLE_MASK;
+            mask = values; mask_width = width; mask_height = height;
+            outside_rate = rate_floor;
+        }
+
+        void set_crop(int left, int top, int right, int bottom) {
+            crop_x0 = left; crop_y0 = top; crop_x1 = right; crop_y1 = bottom;
+        }
+
+        bool cropped() const {
+            return crop_x1 > crop_x0 && crop_y1 > crop_y0;
+        }
+
+        bool skip(int i, int j) const {
+            // Returns true for pixels outside the crop rectangle
+            return cropped() && (i < crop_x0 || i >= crop_x1 || j < crop_y0 || j >= crop_y1);
+        }
+
+        float rate(int i, int j, int width, int height) const {
+            // Returns the sampling rate of pixel (i, j) in [outside_rate, 1]
+            float r = 1.0f;
+            switch (shape) {
+                case SAMPLE_RECT:
+                    r = (i >= x0 && i < x1 && j >= y0 && j < y1) ? 1.0f : outside_rate;
+                    break;
+
+                case SAMPLE_RADIAL: {
+                    float d = std::sqrt((i - cx) * (i - cx) + (j - cy) * (j - cy));
+                    if (d <= inner_radius) {
+                        r = 1.0f;
+                    } else if (d >= outer_radius) {
+                        r = outside_rate;
+                    } else {
+                        // Smoothstep from full rate to the outside rate
+                        float t = (d - inner_radius) / (outer_radius - inner_radius);
+                        t = t * t * (3 - 2 * t);
+                        r = 1.0f + (outside_rate - 1.0f) * t;
+                    }
+                    break;
+                }
+
+                case SAMPLE_MASK:
+                    r = mask_value(i, j, width, height);
+                    break;
+
+                default:
+                    break;
+            }
+            return r < outside_rate ? outside_rate : r;
+        }
+
+        int samples(int i, int j, int width, int height, int spp) const {
+            // Scale the samples per pixel, never below one
+            int n = int(spp * rate(i, j, width, height) + 0.5f);
+            return n < 1 ? 1 : n;
+        }
+
+        int depth(int i, int j, int width, int height, int max_depth) const {
+            // Scale the depth cap, never below two (one bounce)
+            if (!scale_depth) {
+                return max_depth;
+            }
+            int n = int(std::ceil(max_depth * rate(i, j, width, height)));
+            int floor_depth = max_depth < 2 ? max_depth : 2;
+            return n < floor_depth ? floor_depth : n;
+        }
+
+        float row_weight(int j, int width, int height) const {
+            // Returns the sum of the rates of the rendered pixels in row j
+            float sum = 0;
+            for (int i = 0; i < width; i++) {
+                if (!skip(i, j)) {
+                    sum += rate(i, j, width, height);
+                }
+            }
+            return sum;
+        }
+
+    private:
+        float mask_value(int i, int j, int width, int height) const {
+            // Bilinearly sample the mask at the pixel center
+            if (!mask || mask_width <= 0 || mask_height <= 0) {
+                return 1.0f;
+            }
+            float u = (i + 0.5f) * mask_width / width - 0.5f;
+            float v = (j + 0.5f) * mask_height / height - 0.5f;
+            int mu = int(std::floor(u));
+            int mv = int(std::floor(v));
+            float fu = u - mu;
+            float fv = v - mv;
+            float a = texel(mu, mv), b = texel(mu + 1, mv);
+            float c = texel(mu, mv + 1), d = texel(mu + 1, mv + 1);
+            float top = a + (b - a) * fu;
+            float bottom = c + (d - c) * fu;
+            return (top + (bottom - top) * fv) / 255.0f;
+        }
+
+        float texel(int u, int v) const {
+            u = u < 0 ? 0 : (u >= mask_width ? mask_width - 1 : u);
+            v = v < 0 ? 0 : (v >= mask_height ? mask_height - 1 : v);
+            return mask[v * mask_width + u];
+        }
+};
+
+#endif
@@ -11,8 +11,8 @@ class sphere : public hittable {
         // Define the public methods and constructors
         sphere(const point3& cen, float rad, shared_ptr<material> m) : center(cen), radius(fmax(0, rad)), mat_ptr(m) {};
 
-        // Define the hit method
-        virtual bool hit (const ray& r, interval ray_t, hit_record& rec) const override {
+        // Define the intersect method
+        RT_HOT virtual bool intersect(const ray& r, interval ray_t, hit_record& rec) const override {
             // Define the variables
             Vector3 oc = r.origin() - center;
             auto a = r.direction().length_squared();
@@ -37,14 +37,49 @@ class sphere : public hittable {
                 }
             }
 
-            // Set the hit record
+            // Record the distance and the primitive only
             rec.t = root;
+            rec.object = this;
+
+            // Return true
+            return true;
+        }
+
+        // Define the resolve method
+        virtual void resolve(const ray& r, hit_record& rec) const override {
+            // Set the hit record
             rec.p = r.at(rec.t);
             Vector3 outward_normal = (rec.p - center) / radius;
             rec.set_face_normal(r, outward_normal);
             rec.mat_ptr = mat_ptr;
+        }
 
-            // Return true
+        // Define the eager hit method (the single-pass hit this class had before resolve)
+        virtual bool hit_eager(const ray& r, interval ray_t, hit_record& rec) const override {
+            Vector3 oc = r.origin() - center;
+            auto a = r.direction().length_squared();
+            auto h = dot(r.direction(), oc);
+            auto c = oc.length_squared() - radius*radius;
+            auto discriminant = h*h - a*c;
+            if (discriminant < 0) {
+                return false;
+            }
+
+            auto sqrtd = sqrt(discriminant);
+            auto root = (-h - sqrtd) / a;
+            if (!ray_t.surrounds(root)) {
+                root = (-h + sqrtd) / a;
+                if (!ray_t.surrounds(root)) {
+                    return false;
+                }
+            }
+
+            rec.t = root;
+            rec.object = this;
+            rec.p = r.at(rec.t);
+            Vector3 outward_normal = (rec.p - center) / radius;
+            rec.set_face_normal(r, outward_normal);
+            rec.mat_ptr = mat_ptr;
             return true;
         }
 
@@ -0,0 +1,286 @@
+#ifndef TRIANGLE_MESH_H
+#define TRIANGLE_MESH_H
+
+#include "hittable.h"
+#include "vec3.h"
+#include <stdint.h>
+#include <cmath>
+#include <memory>
+
+// Compact mesh format
+//
+// A mesh is one little endian, 4-byte aligned blob, written by
+// tools/obj2mesh.py, that triangle_mesh reads in place. It can sit in flash
+// (a const array), in PSRAM (loaded from SD) or in RAM:
+//
+//   mesh_header
+//   vertices   vertex_count x uint16[3], positions quantized to the mesh AABB
+//   indices    triangle_count x uint16[3] (or uint32[3] with MESH_INDEX32),
+//              in BVH leaf order
+//   nodes      node_count x mesh_node, depth first, left child follows its parent
+//
+// Node bounds use the same 16-bit grid as the vertices, so they are exact
+// and shared vertices dequantize to the same point (the mesh stays watertight).
+
+// Define the format constants
+const uint32_t MESH_MAGIC = 0x48534D54;  // "TMSH"
+const uint16_t MESH_VERSION = 1;
+const uint16_t MESH_INDEX32 = 1;         // header flag: 32-bit indices
+const int MESH_STACK_DEPTH = 48;         // the converter refuses deeper trees
+
+// Define the mesh header
+struct mesh_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t vertex_count;
+    uint32_t triangle_count;
+    uint32_t node_count;
+    float bounds_min[3];
+    float bounds_scale[3];   // position = bounds_min + q * bounds_scale
+    uint32_t vertex_offset;  // byte offsets from the start of the blob
+    uint32_t index_offset;
+    uint32_t node_offset;
+};
+
+// Define the BVH node (16 bytes)
+struct mesh_node {
+    uint16_t lo[3];
+    uint16_t hi[3];
+    uint32_t data;  // leaf: bit 31 set, count - 1 in bits 24..30, first triangle in bits 0..23
+                    // inner: index of the right child (the left child is the next node)
+};
+
+// Define an entry of a generated mesh table (see obj2mesh.py --header)
+struct mesh_asset {
+    const char* name;
+    const uint8_t* data;
+    uint32_t bytes;
+};
+
+// Define the triangle mesh class
+class triangle_mesh : public hittable {
+    public:
+
+        // Define the constructor (blob must outlive the mesh and be 4-byte aligned)
+        triangle_mesh(const uint8_t* blob, shared_ptr<material> m) : mat_ptr(m) {
+            header = reinterpret_cast<const mesh_header*>(blob);
+            if (header->magic != MESH_MAGIC || header->version != MESH_VERSION) {
+                header = nullptr;
+                return;
+            }
+            vertices = reinterpret_cast<const uint16_t*>(blob + header->vertex_offset);
+            indices16 = reinterpret_cast<const uint16_t*>(blob + header->index_offset);
+            indices32 = reinterpret_cast<const uint32_t*>(blob + header->index_offset);
+            nodes = reinterpret_cast<const mesh_node*>(blob + header->node_offset);
+            for (int a = 0; a < 3; a++) {
+                origin[a] = header->bounds_min[a];
+                scale[a] = header->bounds_scale[a];
+            }
+        }
+
+        bool valid() const { return header != nullptr; }
+        uint32_t triangles() const { return header ? header->triangle_count : 0; }
+
+        void bounds(point3& lo, point3& hi) const {
+            lo = point3(origin[0], origin[1], origin[2]);
+            hi = point3(origin[0] + 65535 * scale[0], origin[1] + 65535 * scale[1], origin[2] + 65535 * scale[2]);
+        }
+
+        size_t bytes() const {
+            // Size of the blob: header, vertices, indices and nodes
+            return header ? header->node_offset + header->node_count * sizeof(mesh_node) : 0;
+        }
+
+        // Define the intersect method
+        RT_HOT virtual bool intersect(const ray& r, interval ray_t, hit_record& rec) const override {
+            if (!header || header->node_count == 0) {
+                return false;
+            }
+
+            // Precompute the watertight test's shear for this ray (Woop, Benthin, Wald 2013)
+            shear s;
+            setup_shear(r, s);
+
+            // Precompute the slab test in the quantized grid
+            float inv_dir[3], org_q[3];
+            for (int a = 0; a < 3; a++) {
+                float d = r.dir[a] == 0 ? 1e-30f : r.dir[a];
+                inv_dir[a] = scale[a] / d;
+                org_q[a] = (r.orig[a] - origin[a]) / scale[a];
+            }
+
+            bool hit_anything = false;
+            float closest = ray_t.max;
+            uint32_t stack[MESH_STACK_DEPTH];
+            int top = 0;
+            uint32_t index = 0;
+
+            while (true) {
+                const mesh_node& node = nodes[index];
+                if (node.data & 0x80000000u) {
+                    // Leaf: test its triangles
+                    uint32_t first = node.data & 0x00FFFFFFu;
+                    uint32_t count = ((node.data >> 24) & 0x7Fu) + 1;
+                    for (uint32_t k = first; k < first + count; k++) {
+                        float t;
+                        if (hit_triangle(s, r, k, ray_t.min, closest, t)) {
+                            closest = t;
+                            rec.t = t;
+                            rec.object = this;
+                            rec.primitive = k;
+                            hit_anything = true;
+                        }
+                    }
+                } else {
+                    // Inner: visit the nearer child first
+                    uint32_t left = index + 1, right = node.data;
+                    float t_left, t_right;
+                    bool hit_left = hit_box(nodes[left], org_q, inv_dir, ray_t.min, closest, t_left);
+                    bool hit_right = hit_box(nodes[right], org_q, inv_dir, ray_t.min, closest, t_right);
+                    if (hit_left && hit_right) {
+                        uint32_t near_child = t_left <= t_right ? left : right;
+                        uint32_t far_child = t_left <= t_right ? right : left;
+                        if (top < MESH_STACK_DEPTH) {
+                            stack[top++] = far_child;
+                        }
+                        index = near_child;
+                        continue;
+                    }
+                    if (hit_left || hit_right) {
+                        index = hit_left ? left : right;
+                        continue;
+                    }
+                }
+                if (top == 0) {
+                    break;
+                }
+                index = stack[--top];
+            }
+            return hit_anything;
+        }
+
+        // Define the resolve method
+        virtual void resolve(const ray& r, hit_record& rec) const override {
+            point3 v0, v1, v2;
+            triangle(rec.primitive, v0, v1, v2);
+            rec.p = r.at(rec.t);
+            Vector3 outward_normal = unit_vector(cross(v1 - v0, v2 - v0));
+            rec.set_face_normal(r, outward_normal);
+            rec.mat_ptr = mat_ptr;
+        }
+
+        void triangle(uint32_t k, point3& v0, point3& v1, point3& v2) const {
+            // Dequantize the corners of triangle k
+            uint32_t i0, i1, i2;
+            corners(k, i0, i1, i2);
+            v0 = vertex(i0);
+            v1 = vertex(i1);
+            v2 = vertex(i2);
+        }
+
+    private:
+        const mesh_header* header = nullptr;
+        const uint16_t* vertices = nullptr;
+        const uint16_t* indices16 = nullptr;
+        const uint32_t* indices32 = nullptr;
+        const mesh_node* nodes = nullptr;
+        float origin[3] = {};
+        float scale[3] = {};
+        shared_ptr<material> mat_ptr;
+
+        // Define the per ray state of the watertight test
+        struct shear {
+            int kx, ky, kz;
+            float sx, sy, sz;
+        };
+
+        static void setup_shear(const ray& r, shear& s) {
+            // Make the largest direction component z and shear the others away
+            float ax = fabs(r.dir[0]), ay = fabs(r.dir[1]), az = fabs(r.dir[2]);
+            s.kz = ax > ay ? (ax > az ? 0 : 2) : (ay > az ? 1 : 2);
+            s.kx = (s.kz + 1) % 3;
+            s.ky = (s.kx + 1) % 3;
+            if (r.dir[s.kz] < 0) {
+                int swap = s.kx;
+                s.kx = s.ky;
+                s.ky = swap;
+            }
+            s.sx = r.dir[s.kx] / r.dir[s.kz];
+            s.sy = r.dir[s.ky] / r.dir[s.kz];
+            s.sz = 1.0f / r.dir[s.kz];
+        }
+
+        void corners(uint32_t k, uint32_t& i0, uint32_t& i1, uint32_t& i2) const {
+            if (header->flags & MESH_INDEX32) {
+                i0 = indices32[3 * k]; i1 = indices32[3 * k + 1]; i2 = indices32[3 * k + 2];
+            } else {
+                i0 = indices16[3 * k]; i1 = indices16[3 * k + 1]; i2 = indices16[3 * k + 2];
+            }
+        }
+
+        point3 vertex(uint32_t i) const {
+            const uint16_t* q = vertices + 3 * i;
+            return point3(origin[0] + q[0] * scale[0], origin[1] + q[1] * scale[1], origin[2] + q[2] * scale[2]);
+        }
+
+        static bool hit_box(const mesh_node& node, const float* org_q, const float* inv_dir,
+                            float t_min, float t_max, float& t_enter) {
+            // Slab test against the node bounds, in grid units
+            for (int a = 0; a < 3; a++) {
+                float t0 = (float(node.lo[a]) - org_q[a]) * inv_dir[a];
+                float t1 = (float(node.hi[a]) - org_q[a]) * inv_dir[a];
+                if (t0 > t1) {
+                    float swap = t0;
+                    t0 = t1;
+                    t1 = swap;
+                }
+                // Widen slightly so rays grazing a shared face are never lost
+                t1 *= 1.0000004f;
+                t_min = t0 > t_min ? t0 : t_min;
+                t_max = t1 < t_max ? t1 : t_max;
+                if (t_max < t_min) {
+                    return false;
+                }
+            }
+            t_enter = t_min;
+            return true;
+        }
+
+        bool hit_triangle(const shear& s, const ray& r, uint32_t k, float t_min, float t_max, float& t) const {
+            // Watertight ray/triangle test
+            point3 v0, v1, v2;
+            triangle(k, v0, v1, v2);
+            Vector3 a = v0 - r.orig, b = v1 - r.orig, c = v2 - r.orig;
+
+            float ax = a[s.kx] - s.sx * a[s.kz], ay = a[s.ky] - s.sy * a[s.kz];
+            float bx = b[s.kx] - s.sx * b[s.kz], by = b[s.ky] - s.sy * b[s.kz];
+            float cx = c[s.kx] - s.sx * c[s.kz], cy = c[s.ky] - s.sy * c[s.kz];
+
+            float u = cx * by - cy * bx;
+            float v = ax * cy - ay * cx;
+            float w = bx * ay - by * ax;
+
+            // Fall back to double precision exactly on an edge
+            if (u == 0.0f || v == 0.0f || w == 0.0f) {
+                u = float(double(cx) * double(by) - double(cy) * double(bx));
+                v = float(double(ax) * double(cy) - double(ay) * double(cx));
+                w = float(double(bx) * double(ay) - double(by) * double(ax));
+            }
+
+            if ((u < 0 || v < 0 || w < 0) && (u > 0 || v > 0 || w > 0)) {
+                return false;
+            }
+            float det = u + v + w;
+            if (det == 0.0f) {
+                return false;
+            }
+
+            float az = s.sz * a[s.kz], bz = s.sz * b[s.kz], cz = s.sz * c[s.kz];
+            float scaled_t = u * az + v * bz + w * cz;
+            t = scaled_t / det;
+            return t > t_min && t < t_max;
+        }
+};
+
+#endif
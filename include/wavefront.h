@@ -0,0 +1,262 @@
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include "ray_tracing.h"
+#include "material.h"
+#include "memory_tier.h"
+
+// Wavefront path tracing
+//
+// Instead of following one path at a time through ray_color, a batch of
+// paths advances one bounce at a time through separate stages:
+//
+//   generate -> intersect -> sort by material -> shade per material -> compact
+//
+// Each stage is a tight loop over structure-of-arrays ray state, and each
+// shading loop only ever runs one material's scatter code. The camera owns
+// the generate stage (see camera::render_wavefront); this file holds the
+// queue and the stages that only need the scene.
+
+// Define the bucket index for rays that left the scene
+const int WAVEFRONT_MISS = MATERIAL_KIND_COUNT;
+
+// Define the ray queue class
+class ray_queue {
+    public:
+        // Define the ray state (all arrays live in one block, placed like the scene, DTCM first)
+        float *ox, *oy, *oz;                // origin
+        float *dx, *dy, *dz;                // direction
+        float *tr, *tg, *tb;                // throughput
+        uint16_t* pixel;                    // index into the accumulators
+
+        // Define the hit state
+        float* t;
+        const hittable** object;
+        uint32_t* primitive;
+        const material** mat;
+        float *nx, *ny, *nz;
+        uint8_t *front, *alive, *kind;
+
+        // Define the material sort (ray indices grouped by bucket)
+        uint16_t* order;
+        int bucket_start[MATERIAL_KIND_COUNT + 2];
+
+        // Define the per pixel accumulators of the batch
+        float *ar, *ag, *ab;
+
+        // Define the number of live rays and the rays traced so far
+        int count = 0;
+        uint32_t rays_traced = 0;
+
+        ray_queue(int batch_size) : capacity(batch_size < 1 ? 1 : (batch_size > 65535 ? 65535 : batch_size)) {
+            // Allocate every array at once, widest alignment first, so the queue sits in one tier
+            block = static_cast<uint8_t*>(scene_arena().allocate(bytes(), alignof(void*)));
+            uint8_t* next = block;
+            object = carve<const hittable*>(next);
+            mat = carve<const material*>(next);
+            for (float** v : { &ox, &oy, &oz, &dx, &dy, &dz, &tr, &tg, &tb, &t, &nx, &ny, &nz, &ar, &ag, &ab }) {
+                *v = carve<float>(next);
+            }
+            primitive = carve<uint32_t>(next);
+            pixel = carve<uint16_t>(next);
+            order = carve<uint16_t>(next);
+            front = carve<uint8_t>(next);
+            alive = carve<uint8_t>(next);
+            kind = carve<uint8_t>(next);
+        }
+
+        ~ray_queue() {
+            scene_arena().deallocate(block, bytes());
+        }
+
+        ray_queue(const ray_queue&) = delete;
+        ray_queue& operator=(const ray_queue&) = delete;
+
+        int size() const {
+            return capacity;
+        }
+
+        const void* data() const {
+            return block;
+        }
+
+        size_t bytes() const {
+            // Bytes of ray state per batch
+            return size_t(capacity) * (16 * sizeof(float) + 2 * sizeof(uint16_t) + sizeof(const hittable*)
+                                       + sizeof(uint32_t) + sizeof(const material*) + 3 * sizeof(uint8_t));
+        }
+
+        void push(const ray& r, uint16_t pixel_index) {
+            // Append a fresh camera ray with unit throughput
+            int i = count++;
+            ox[i] = r.orig[0]; oy[i] = r.orig[1]; oz[i] = r.orig[2];
+            dx[i] = r.dir[0]; dy[i] = r.dir[1]; dz[i] = r.dir[2];
+            tr[i] = tg[i] = tb[i] = 1.0f;
+            pixel[i] = pixel_index;
+        }
+
+        ray ray_at(int i) const {
+            return ray(point3(ox[i], oy[i], oz[i]), Vector3(dx[i], dy[i], dz[i]));
+        }
+
+        RT_HOT void intersect(const hittable& world) {
+            // Stage: closest hit for every live ray (t and primitive only)
+            for (int i = 0; i < count; i++) {
+                hit_record rec;
+                object[i] = world.intersect(ray_at(i), interval(0.001, inf), rec) ? rec.object : nullptr;
+                t[i] = rec.t;
+                primitive[i] = rec.primitive;
+            }
+            rays_traced += count;
+        }
+
+        RT_HOT void sort_by_material() {
+            // Stage: resolve the hits and counting-sort the rays by material
+            int counts[MATERIAL_KIND_COUNT + 1] = {};
+            for (int i = 0; i < count; i++) {
+                kind[i] = WAVEFRONT_MISS;
+                if (object[i]) {
+                    hit_record rec;
+                    rec.t = t[i];
+                    rec.object = object[i];
+                    rec.primitive = primitive[i];
+                    object[i]->resolve(ray_at(i), rec);
+                    mat[i] = rec.mat_ptr.get();
+                    nx[i] = rec.normal[0]; ny[i] = rec.normal[1]; nz[i] = rec.normal[2];
+                    front[i] = rec.front_face;
+                    kind[i] = mat[i]->kind;
+                }
+                counts[kind[i]]++;
+            }
+
+            bucket_start[0] = 0;
+            for (int k = 0; k <= MATERIAL_KIND_COUNT; k++) {
+                bucket_start[k + 1] = bucket_start[k] + counts[k];
+            }
+            int next[MATERIAL_KIND_COUNT + 1];
+            for (int k = 0; k <= MATERIAL_KIND_COUNT; k++) {
+                next[k] = bucket_start[k];
+            }
+            for (int i = 0; i < count; i++) {
+                order[next[kind[i]]++] = uint16_t(i);
+            }
+        }
+
+        RT_HOT void shade_misses() {
+            // Stage: rays that left the scene pick up the sky and retire
+            for (int k = bucket_start[WAVEFRONT_MISS]; k < bucket_start[WAVEFRONT_MISS + 1]; k++) {
+                int i = order[k];
+                float inv_length = 1.0f / std::sqrt(dx[i] * dx[i] + dy[i] * dy[i] + dz[i] * dz[i]);
+                float a = 0.5f * (dy[i] * inv_length + 1.0f);
+                ar[pixel[i]] += tr[i] * ((1.0f - a) + a * 0.5f);
+                ag[pixel[i]] += tg[i] * ((1.0f - a) + a * 0.7f);
+                ab[pixel[i]] += tb[i];
+                alive[i] = 0;
+            }
+        }
+
+        template <class M>
+        RT_HOT void shade(material_kind bucket) {
+            // Stage: scatter every ray of one material with that material's own code
+            for (int k = bucket_start[bucket]; k < bucket_start[bucket + 1]; k++) {
+                int i = order[k];
+                ray r_in = ray_at(i);
+                hit_record rec;
+                rec.t = t[i];
+                rec.p = r_in.at(t[i]);
+                rec.normal = Vector3(nx[i], ny[i], nz[i]);
+                rec.front_face = front[i];
+
+                Color attenuation;
+                ray scattered;
+                if (static_cast<const M*>(mat[i])->M::scatter(r_in, rec, attenuation, scattered)) {
+                    store(i, scattered, attenuation);
+                } else {
+                    alive[i] = 0;
+                }
+            }
+        }
+
+        void shade_other() {
+            // Stage: materials without a specialised loop go through the virtual call
+            for (int k = bucket_start[MATERIAL_OTHER]; k < bucket_start[MATERIAL_OTHER + 1]; k++) {
+                int i = order[k];
+                ray r_in = ray_at(i);
+                hit_record rec;
+                rec.t = t[i];
+                rec.p = r_in.at(t[i]);
+                rec.normal = Vector3(nx[i], ny[i], nz[i]);
+                rec.front_face = front[i];
+
+                Color attenuation;
+                ray scattered;
+                if (mat[i]->scatter(r_in, rec, attenuation, scattered)) {
+                    store(i, scattered, attenuation);
+                } else {
+                    alive[i] = 0;
+                }
+            }
+        }
+
+        void compact() {
+            // Stage: squeeze the surviving rays to the front of the queue
+            int n = 0;
+            for (int i = 0; i < count; i++) {
+                if (!alive[i]) {
+                    continue;
+                }
+                if (n != i) {
+                    ox[n] = ox[i]; oy[n] = oy[i]; oz[n] = oz[i];
+                    dx[n] = dx[i]; dy[n] = dy[i]; dz[n] = dz[i];
+                    tr[n] = tr[i]; tg[n] = tg[i]; tb[n] = tb[i];
+                    pixel[n] = pixel[i];
+                }
+                n++;
+            }
+            count = n;
+        }
+
+        void bounce(const hittable& world) {
+            // Advance every live ray by one bounce
+            intersect(world);
+            sort_by_material();
+            for (int i = 0; i < count; i++) {
+                alive[i] = 1;
+            }
+            shade_misses();
+            shade<lambertian>(MATERIAL_LAMBERTIAN);
+            shade<metal>(MATERIAL_METAL);
+            shade<dielectric>(MATERIAL_DIELECTRIC);
+            shade_other();
+            compact();
+        }
+
+        void clear_accumulators(int pixels) {
+            for (int p = 0; p < pixels; p++) {
+                ar[p] = ag[p] = ab[p] = 0;
+            }
+        }
+
+    private:
+        int capacity;
+        uint8_t* block;
+
+        template <class T>
+        T* carve(uint8_t*& next) {
+            // Hand out the next capacity elements of the block
+            T* array = reinterpret_cast<T*>(next);
+            next += size_t(capacity) * sizeof(T);
+            return array;
+        }
+
+        void store(int i, const ray& scattered, const Color& attenuation) {
+            // Replace ray i by its scattered continuation
+            ox[i] = scattered.orig[0]; oy[i] = scattered.orig[1]; oz[i] = scattered.orig[2];
+            dx[i] = scattered.dir[0]; dy[i] = scattered.dir[1]; dz[i] = scattered.dir[2];
+            tr[i] *= attenuation[0];
+            tg[i] *= attenuation[1];
+            tb[i] *= attenuation[2];
+        }
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include <ray_tracing.h>
 #include <camera.h>
 #include "material.h"
+#include "bench.h"
+#include "checkpoint.h"
 
 // Define the pins used for the display
 #define TFT_CS 10
@@ -11,7 +13,39 @@
 // Create an instance of the display
 Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC);
 
+// Define the scene and the camera (they outlive setup() so loop() can keep rendering)
+hittable_list world;
+camera cam;
+
+#ifdef RT_CHECKPOINT
+// Render progressively from loop() and checkpoint to the SD card, resuming after a reset
+#ifndef RT_CHECKPOINT_PATH
+#define RT_CHECKPOINT_PATH "render.ckp"
+#endif
+#ifndef RT_PASS_SAMPLES
+#define RT_PASS_SAMPLES 4
+#endif
+#ifndef RT_STEP_MS
+#define RT_STEP_MS 50
+#endif
+render_state state;
+sd_store sd;
+render_checkpoint checkpoint(sd);
+#endif
+
+#ifdef RT_STREAM_FRAMES
+// Stream every finished row to the host over USB serial (see tools/frame_receiver.py)
+#ifndef RT_STREAM_ENCODING
+#define RT_STREAM_ENCODING ENCODING_QOI565
+#endif
+serial_sink usb_sink(Serial);
+frame_stream usb_stream(usb_sink);
+#endif
+
 void setup() {
+  // Open the USB serial port for reports (and the frame stream)
+  Serial.begin(115200);
+
   // Set up the display by beginning the SPI connection
   SPI.setMOSI(TFT_MOSI);
   SPI.setSCK(TFT_CLK);
@@ -24,12 +58,12 @@ void setup() {
 
     tft.fillScreen(ILI9341_BLACK);
 
-    // Create the World
-    hittable_list world;
+    // Create the World (room for the ground, up to 22x22 small spheres and the three main ones)
+    world.reserve(1 + 22 * 22 + 3);
 
     // Create the ground for the final scene
-    auto ground_material = make_shared<lambertian>(Color(0.5, 0.5, 0.5));
-    world.add(make_shared<sphere>(point3(0,-1000,0), 1000, ground_material));
+    auto ground_material = make_placed<lambertian>(Color(0.5, 0.5, 0.5));
+    world.add(make_placed<sphere>(point3(0,-1000,0), 1000, ground_material));
 
     // Create the random spheres for the final scene
     for (int a = -11; a < 11; a++) {
@@ -43,35 +77,37 @@ void setup() {
                 if (choose_mat < 0.8) {
                     // diffuse
                     auto albedo = Color::random() * Color::random();
-                    sphere_material = make_shared<lambertian>(albedo);
-                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
+                    sphere_material = make_placed<lambertian>(albedo);
+                    world.add(make_placed<sphere>(center, 0.2, sphere_material));
                 } else if (choose_mat < 0.95) {
                     // metal
                     auto albedo = Color::random(0.5, 1);
                     auto fuzz = random_float(0, 0.5);
-                    sphere_material = make_shared<metal>(albedo, fuzz);
-                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
+                    sphere_material = make_placed<metal>(albedo, fuzz);
+                    world.add(make_placed<sphere>(center, 0.2, sphere_material));
                 } else {
                     // glass
-                    sphere_material = make_shared<dielectric>(1.5);
-                    world.add(make_shared<sphere>(center, 0.2, sphere_material));
+                    sphere_material = make_placed<dielectric>(1.5);
+                    world.add(make_placed<sphere>(center, 0.2, sphere_material));
                 }
             }
         }
     }
 
     // Create the three main spheres for the final scene
-    auto material1 = make_shared<dielectric>(1.5);
-    world.add(make_shared<sphere>(point3(0, 1, 0), 1.0, material1));
+    auto material1 = make_placed<dielectric>(1.5);
+    world.add(make_placed<sphere>(point3(0, 1, 0), 1.0, material1));
 
-    auto material2 = make_shared<lambertian>(Color(0.4, 0.2, 0.1));
-    world.add(make_shared<sphere>(point3(-4, 1, 0), 1.0, material2));
+    auto material2 = make_placed<lambertian>(Color(0.4, 0.2, 0.1));
+    world.add(make_placed<sphere>(point3(-4, 1, 0), 1.0, material2));
 
-    auto material3 = make_shared<metal>(Color(0.7, 0.6, 0.5), 0.0);
-    world.add(make_shared<sphere>(point3(4, 1, 0), 1.0, material3));
+    auto material3 = make_placed<metal>(Color(0.7, 0.6, 0.5), 0.0);
+    world.add(make_placed<sphere>(point3(4, 1, 0), 1.0, material3));
     
-    // Create the camera
-    camera cam;
+#ifndef RT_BENCHMARK
+    // Report where the code and the scene landed (the benchmarks print their own)
+    print_memory_map(Serial);
+#endif
 
     // Set the camera properties
     cam.sample_per_pixel = 500;
@@ -85,10 +121,66 @@ void setup() {
     cam.defocus_angle = 0.6;
     cam.focus_distance = 10.0;
 
+#ifdef RT_STREAM_FRAMES
+    // Attach the USB frame stream
+    usb_stream.encoding = RT_STREAM_ENCODING;
+    cam.stream = &usb_stream;
+#endif
+
+#ifdef RT_FOVEATED
+    // Spend the samples on the three hero spheres in the middle of the frame
+    static sample_map fovea;
+    fovea.set_radial(tft.width() / 2, tft.height() / 2, tft.height() / 4, tft.height() * 3 / 4, 0.05);
+    cam.rate_map = &fovea;
+#endif
+
+#ifdef RT_BENCHMARK
+    // Measure the scene instead of rendering it
+    while (!Serial && millis() < 4000) {}
+    run_benchmarks(Serial, world, cam, tft);
+    return;
+#endif
+
+#ifdef RT_CHECKPOINT
+    // Pick up the checkpoint of this scene if there is one, then let loop() render
+    if (state.begin(tft.width(), tft.height(), cam.sample_per_pixel, RT_PASS_SAMPLES,
+                    cam.fingerprint(world, tft.width(), tft.height()))) {
+        if (checkpoint.resume(RT_CHECKPOINT_PATH, state)) {
+            cam.show(tft, state);
+            Serial.printf("checkpoint: resumed %lu tiles from %s\n", (unsigned long)checkpoint.tiles_restored, RT_CHECKPOINT_PATH);
+        } else if (!checkpoint.active()) {
+            Serial.printf("checkpoint: no SD card, rendering without checkpoints\n");
+        }
+        state.print(Serial);
+        return;
+    }
+    Serial.printf("checkpoint: no room for the render state, rendering in one go\n");
+#endif
+
+#ifdef RT_TIME_BUDGET_MS
+    // Render the best image that fits in the time budget and report how it went
+    render_budget budget;
+    cam.render_budgeted(tft, world, uint32_t(RT_TIME_BUDGET_MS) * 1000, budget);
+    budget.print(Serial);
+#else
     // Render the scene
     cam.render(tft, world);
+#endif
 }
 
 void loop() {
-    // Do nothing
+#ifdef RT_CHECKPOINT
+    // Advance the progressive render one bounded step and checkpoint when due
+    if (!state.ready() || state.done()) {
+        return;
+    }
+    bool finished = cam.render_step(tft, world, state, uint32_t(RT_STEP_MS) * 1000);
+    if (finished || checkpoint.due(state)) {
+        checkpoint.save(state);
+    }
+    if (finished) {
+        state.print(Serial);
+        checkpoint.print(Serial, state);
+    }
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef TEST_STUBS_ADAFRUIT_ILI9341_H
+#define TEST_STUBS_ADAFRUIT_ILI9341_H
+
+// Host stand-in for the display: a 320x240 RGB565 framebuffer in memory
+
+#include "Arduino.h"
+
+#define ILI9341_BLACK 0x0000
+
+class Adafruit_ILI9341 {
+    public:
+        uint16_t pixels[320 * 240] = {};
+
+        Adafruit_ILI9341(int8_t /*cs*/, int8_t /*dc*/) {}
+
+        void begin() {}
+        void setRotation(uint8_t /*rotation*/) {}
+        void fillScreen(uint16_t color) {
+            for (uint16_t& p : pixels) {
+                p = color;
+            }
+        }
+
+        int16_t width() const { return 320; }
+        int16_t height() const { return 240; }
+
+        uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+            return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+        }
+
+        void drawPixel(int16_t x, int16_t y, uint16_t color) {
+            if (x >= 0 && x < 320 && y >= 0 && y < 240) {
+                pixels[y * 320 + x] = color;
+            }
+        }
+};
+
+#endif
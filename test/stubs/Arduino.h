@@ -0,0 +1,50 @@
+#ifndef TEST_STUBS_ARDUINO_H
+#define TEST_STUBS_ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core the renderer headers use,
+// so the native tests can build them without a board
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+inline uint32_t micros() {
+    using namespace std::chrono;
+    return uint32_t(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+// Define a Print that writes to stdout
+class Print {
+    public:
+        virtual ~Print() = default;
+
+        virtual size_t write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+        virtual size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stdout); }
+        virtual int availableForWrite() { return 64; }
+
+        int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+            va_list args;
+            va_start(args, format);
+            int written = vprintf(format, args);
+            va_end(args);
+            return written;
+        }
+};
+
+class usb_serial_class : public Print {
+    public:
+        void begin(long) {}
+        operator bool() { return true; }
+};
+
+inline usb_serial_class Serial;
+
+#endif
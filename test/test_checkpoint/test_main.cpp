@@ -0,0 +1,155 @@
+#include <unity.h>
+#include "ray_tracing.h"
+#include "camera.h"
+#include "material.h"
+#include "checkpoint.h"
+
+// Checkpoint tests
+//
+// Render a small scene progressively into a file_store checkpoint, stop
+// halfway, resume into a fresh render_state and check the result matches a
+// render that was never interrupted; then check that a torn tile and a
+// checkpoint of another render are not restored.
+
+const char* CHECKPOINT_PATH = "test_checkpoint.ckp";
+const int SPP = 4;
+const int PASS_SAMPLES = 2;
+
+Adafruit_ILI9341 tft(0, 0);
+hittable_list world;
+camera cam;
+uint32_t scene_hash;
+render_state reference;
+
+void build_scene() {
+    world.add(make_placed<sphere>(point3(0, -1000, 0), 1000, make_placed<lambertian>(Color(0.5, 0.5, 0.5))));
+    world.add(make_placed<sphere>(point3(0, 1, 0), 1.0, make_placed<dielectric>(1.5)));
+    world.add(make_placed<sphere>(point3(-4, 1, 0), 1.0, make_placed<lambertian>(Color(0.4, 0.2, 0.1))));
+    world.add(make_placed<sphere>(point3(4, 1, 0), 1.0, make_placed<metal>(Color(0.7, 0.6, 0.5), 0.0)));
+
+    cam.sample_per_pixel = SPP;
+    cam.max_depth = 10;
+    cam.vfov = 20;
+    cam.lookfrom = point3(13, 2, 3);
+    cam.lookat = point3(0, 0, 0);
+    cam.vup = Vector3(0, 1, 0);
+    cam.defocus_angle = 0.6;
+    cam.focus_distance = 10.0;
+    scene_hash = cam.fingerprint(world, tft.width(), tft.height());
+}
+
+bool begin_state(render_state& state, uint32_t hash) {
+    return state.begin(tft.width(), tft.height(), SPP, PASS_SAMPLES, hash);
+}
+
+void render_passes(render_state& state, render_checkpoint* checkpoint, uint32_t passes) {
+    // Render up to the given number of tile passes in total (a zero budget is one pass per step)
+    while (state.passes_done() < passes && !cam.render_step(tft, world, state, 0)) {
+        if (checkpoint && checkpoint->due(state)) {
+            checkpoint->save(state);
+        }
+    }
+}
+
+bool same_tile(const render_state& a, const render_state& b, int tile) {
+    return a.passes[tile] == b.passes[tile]
+           && memcmp(a.tile_accum(tile), b.tile_accum(tile), size_t(a.tile_pixels()) * 3 * sizeof(float)) == 0
+           && memcmp(a.tile_counts(tile), b.tile_counts(tile), size_t(a.tile_pixels()) * sizeof(uint16_t)) == 0;
+}
+
+void interrupt_halfway() {
+    // Write a checkpoint of a render that stops after half of its passes
+    remove(CHECKPOINT_PATH);
+    render_state state;
+    TEST_ASSERT_TRUE(begin_state(state, scene_hash));
+    file_store store;
+    render_checkpoint checkpoint(store);
+    checkpoint.min_interval_us = 0;
+    TEST_ASSERT_FALSE(checkpoint.resume(CHECKPOINT_PATH, state));
+    TEST_ASSERT_TRUE(checkpoint.active());
+    render_passes(state, &checkpoint, state.tile_count() * state.total_passes() / 2);
+    TEST_ASSERT_TRUE(checkpoint.save(state));
+}
+
+uint32_t tile_record_offset(const render_state& state, int tile) {
+    return sizeof(checkpoint_header) + uint32_t(tile) * (8 + state.tile_bytes());
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_resume_matches_uninterrupted() {
+    interrupt_halfway();
+
+    render_state state;
+    TEST_ASSERT_TRUE(begin_state(state, scene_hash));
+    file_store store;
+    render_checkpoint checkpoint(store);
+    TEST_ASSERT_TRUE(checkpoint.resume(CHECKPOINT_PATH, state));
+    TEST_ASSERT_EQUAL_UINT32(0, checkpoint.tiles_rejected);
+    TEST_ASSERT_EQUAL_UINT32(state.tile_count() * state.total_passes() / 2, state.passes_done());
+
+    render_passes(state, &checkpoint, state.tile_count() * state.total_passes());
+    TEST_ASSERT_TRUE(state.done());
+    for (int t = 0; t < state.tile_count(); t++) {
+        TEST_ASSERT_TRUE_MESSAGE(same_tile(reference, state, t), "resumed tile differs from the uninterrupted render");
+    }
+}
+
+void test_corrupt_tile_is_rendered_again() {
+    interrupt_halfway();
+
+    // Flip one byte of a tile's radiance behind the CRC's back
+    const int torn = 5;
+    render_state state;
+    TEST_ASSERT_TRUE(begin_state(state, scene_hash));
+    FILE* file = fopen(CHECKPOINT_PATH, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    uint32_t offset = tile_record_offset(state, torn) + 8 + uint32_t(state.tile_pixels()) * sizeof(uint16_t) + 100;
+    fseek(file, long(offset), SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, long(offset), SEEK_SET);
+    fputc(byte ^ 0x55, file);
+    fclose(file);
+
+    file_store store;
+    render_checkpoint checkpoint(store);
+    checkpoint.resume(CHECKPOINT_PATH, state);
+    TEST_ASSERT_EQUAL_UINT32(1, checkpoint.tiles_rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, state.passes[torn]);
+    TEST_ASSERT_EQUAL_UINT32((state.tile_count() - 1) * (state.total_passes() / 2), state.passes_done());
+
+    // The torn tile starts over and the finished render is still exact
+    render_passes(state, &checkpoint, state.tile_count() * state.total_passes());
+    for (int t = 0; t < state.tile_count(); t++) {
+        TEST_ASSERT_TRUE(same_tile(reference, state, t));
+    }
+}
+
+void test_other_render_is_not_resumed() {
+    interrupt_halfway();
+
+    render_state state;
+    TEST_ASSERT_TRUE(begin_state(state, scene_hash ^ 1));
+    file_store store;
+    render_checkpoint checkpoint(store);
+    TEST_ASSERT_FALSE(checkpoint.resume(CHECKPOINT_PATH, state));
+    TEST_ASSERT_TRUE(checkpoint.active());
+    TEST_ASSERT_EQUAL_UINT32(0, checkpoint.tiles_restored);
+    TEST_ASSERT_EQUAL_UINT32(0, state.passes_done());
+}
+
+int main() {
+    build_scene();
+    if (!begin_state(reference, scene_hash)) {
+        return 1;
+    }
+    render_passes(reference, nullptr, reference.tile_count() * reference.total_passes());
+
+    UNITY_BEGIN();
+    RUN_TEST(test_resume_matches_uninterrupted);
+    RUN_TEST(test_corrupt_tile_is_rendered_again);
+    RUN_TEST(test_other_render_is_not_resumed);
+    remove(CHECKPOINT_PATH);
+    return UNITY_END();
+}
@@ -0,0 +1,246 @@
+// Generated by tools/obj2mesh.py, do not edit
+#ifndef SPHERE_MESH_H
+#define SPHERE_MESH_H
+
+#include "triangle_mesh.h"
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+alignas(4) const uint8_t sphere_320_mesh[5460] PROGMEM = {
+    84,77,83,72,1,0,0,0,146,0,0,0,32,1,0,0,175,0,0,0,92,28,124,191,
+    0,0,128,191,217,71,120,191,89,29,252,55,128,0,0,56,209,72,248,55,56,0,0,0,
+    164,3,0,0,100,10,0,0,0,128,255,255,0,128,116,172,71,248,0,128,197,169,71,248,
+    112,143,13,162,71,248,3,157,58,150,71,248,23,167,184,135,71,248,116,172,71,120,71,248,
+    116,172,197,105,71,248,23,167,242,93,71,248,3,157,58,86,71,248,112,143,139,83,71,248,
+    0,128,58,86,71,248,143,112,242,93,71,248,252,98,197,105,71,248,232,88,71,120,71,248,
+    139,83,184,135,71,248,139,83,58,150,71,248,232,88,13,162,71,248,252,98,197,169,71,248,
+    143,112,139,211,13,226,0,128,129,206,13,226,3,157,255,191,13,226,135,182,197,169,13,226,
+    119,201,129,142,13,226,139,211,126,113,13,226,139,211,58,86,13,226,119,201,0,64,13,226,
+    135,182,126,49,13,226,3,157,116,44,13,226,0,128,126,49,13,226,252,98,0,64,13,226,
+    120,73,58,86,13,226,136,54,126,113,13,226,116,44,129,142,13,226,116,44,197,169,13,226,
+    136,54,255,191,13,226,120,73,129,206,13,226,252,98,143,240,255,191,0,128,197,233,255,191,
+    23,167,57,214,255,191,119,201,71,184,255,191,251,226,139,147,255,191,143,240,116,108,255,191,
+    143,240,184,71,255,191,251,226,198,41,255,191,119,201,58,22,255,191,23,167,112,15,255,191,
+    0,128,58,22,255,191,232,88,198,41,255,191,136,54,184,71,255,191,4,29,116,108,255,191,
+    112,15,139,147,255,191,112,15,71,184,255,191,4,29,57,214,255,191,136,54,197,233,255,191,
+    232,88,255,255,58,150,0,128,71,248,58,150,116,172,13,226,58,150,139,211,255,191,58,150,
+    143,240,58,150,58,150,255,255,197,105,58,150,255,255,0,64,58,150,143,240,242,29,58,150,
+    139,211,184,7,58,150,116,172,0,0,58,150,0,128,184,7,58,150,139,83,242,29,58,150,
+    116,44,0,64,58,150,112,15,197,105,58,150,0,0,58,150,58,150,0,0,255,191,58,150,
+    112,15,13,226,58,150,116,44,71,248,58,150,139,83,255,255,197,105,0,128,71,248,197,105,
+    116,172,13,226,197,105,139,211,255,191,197,105,143,240,58,150,197,105,255,255,197,105,197,105,
+    255,255,0,64,197,105,143,240,242,29,197,105,139,211,184,7,197,105,116,172,0,0,197,105,
+    0,128,184,7,197,105,139,83,242,29,197,105,116,44,0,64,197,105,112,15,197,105,197,105,
+    0,0,58,150,197,105,0,0,255,191,197,105,112,15,13,226,197,105,116,44,71,248,197,105,
+    139,83,143,240,0,64,0,128,197,233,0,64,23,167,57,214,0,64,119,201,71,184,0,64,
+    251,226,139,147,0,64,143,240,116,108,0,64,143,240,184,71,0,64,251,226,198,41,0,64,
+    119,201,58,22,0,64,23,167,112,15,0,64,0,128,58,22,0,64,232,88,198,41,0,64,
+    136,54,184,71,0,64,4,29,116,108,0,64,112,15,139,147,0,64,112,15,71,184,0,64,
+    4,29,57,214,0,64,136,54,197,233,0,64,232,88,139,211,242,29,0,128,129,206,242,29,
+    3,157,255,191,242,29,135,182,197,169,242,29,119,201,129,142,242,29,139,211,126,113,242,29,
+    139,211,58,86,242,29,119,201,0,64,242,29,135,182,126,49,242,29,3,157,116,44,242,29,
+    0,128,126,49,242,29,252,98,0,64,242,29,120,73,58,86,242,29,136,54,126,113,242,29,
+    116,44,129,142,242,29,116,44,197,169,242,29,136,54,255,191,242,29,120,73,129,206,242,29,
+    252,98,116,172,184,7,0,128,197,169,184,7,112,143,13,162,184,7,3,157,58,150,184,7,
+    23,167,184,135,184,7,116,172,71,120,184,7,116,172,197,105,184,7,23,167,242,93,184,7,
+    3,157,58,86,184,7,112,143,139,83,184,7,0,128,58,86,184,7,143,112,242,93,184,7,
+    252,98,197,105,184,7,232,88,71,120,184,7,139,83,184,135,184,7,139,83,58,150,184,7,
+    232,88,13,162,184,7,252,98,197,169,184,7,143,112,0,128,0,0,0,128,84,0,85,0,
+    103,0,84,0,103,0,102,0,102,0,103,0,121,0,83,0,84,0,102,0,102,0,121,0,
+    120,0,83,0,102,0,101,0,101,0,102,0,120,0,119,0,120,0,138,0,119,0,138,0,
+    137,0,118,0,119,0,137,0,118,0,137,0,136,0,101,0,120,0,119,0,100,0,101,0,
+    119,0,100,0,119,0,118,0,82,0,83,0,101,0,82,0,101,0,100,0,85,0,86,0,
+    104,0,85,0,104,0,103,0,103,0,104,0,122,0,103,0,122,0,121,0,86,0,105,0,
+    104,0,86,0,87,0,105,0,104,0,123,0,122,0,104,0,105,0,123,0,121,0,122,0,
+    140,0,120,0,121,0,139,0,121,0,140,0,139,0,120,0,139,0,138,0,145,0,139,0,
+    140,0,145,0,138,0,139,0,145,0,137,0,138,0,145,0,136,0,137,0,122,0,141,0,
+    140,0,122,0,123,0,141,0,123,0,142,0,141,0,145,0,140,0,141,0,145,0,141,0,
+    142,0,66,0,67,0,85,0,66,0,85,0,84,0,48,0,67,0,66,0,48,0,49,0,
+    67,0,65,0,66,0,84,0,65,0,84,0,83,0,64,0,65,0,83,0,64,0,83,0,
+    82,0,47,0,66,0,65,0,47,0,48,0,66,0,46,0,65,0,64,0,46,0,47,0,
+    65,0,30,0,49,0,48,0,29,0,48,0,47,0,29,0,30,0,48,0,28,0,47,0,
+    46,0,28,0,29,0,47,0,10,0,29,0,28,0,11,0,30,0,29,0,10,0,11,0,
+    29,0,67,0,68,0,86,0,67,0,86,0,85,0,49,0,68,0,67,0,49,0,50,0,
+    68,0,68,0,69,0,87,0,68,0,87,0,86,0,50,0,51,0,69,0,50,0,69,0,
+    68,0,30,0,31,0,49,0,31,0,50,0,49,0,31,0,32,0,50,0,32,0,33,0,
+    51,0,32,0,51,0,50,0,13,0,32,0,31,0,12,0,31,0,30,0,12,0,13,0,
+    31,0,11,0,12,0,30,0,0,0,13,0,12,0,0,0,12,0,11,0,0,0,11,0,
+    10,0,14,0,33,0,32,0,14,0,15,0,33,0,13,0,14,0,32,0,0,0,14,0,
+    13,0,0,0,15,0,14,0,0,0,16,0,15,0,105,0,124,0,123,0,105,0,106,0,
+    124,0,106,0,125,0,124,0,123,0,124,0,142,0,124,0,143,0,142,0,124,0,125,0,
+    143,0,106,0,107,0,125,0,107,0,126,0,125,0,107,0,108,0,126,0,145,0,142,0,
+    143,0,145,0,143,0,144,0,145,0,144,0,127,0,125,0,144,0,143,0,125,0,126,0,
+    144,0,126,0,127,0,144,0,126,0,109,0,127,0,108,0,109,0,126,0,108,0,91,0,
+    109,0,87,0,106,0,105,0,69,0,70,0,88,0,69,0,88,0,87,0,87,0,88,0,
+    106,0,88,0,107,0,106,0,70,0,71,0,89,0,70,0,89,0,88,0,88,0,89,0,
+    107,0,89,0,108,0,107,0,89,0,90,0,108,0,90,0,73,0,91,0,90,0,91,0,
+    108,0,71,0,72,0,90,0,71,0,90,0,89,0,72,0,55,0,73,0,72,0,73,0,
+    90,0,51,0,70,0,69,0,51,0,52,0,70,0,33,0,52,0,51,0,33,0,34,0,
+    52,0,15,0,34,0,33,0,15,0,16,0,34,0,16,0,35,0,34,0,52,0,71,0,
+    70,0,34,0,53,0,52,0,52,0,53,0,71,0,34,0,35,0,53,0,53,0,72,0,
+    71,0,35,0,54,0,53,0,53,0,54,0,72,0,0,0,17,0,16,0,0,0,18,0,
+    17,0,0,0,1,0,18,0,16,0,17,0,35,0,17,0,36,0,35,0,17,0,18,0,
+    36,0,18,0,19,0,36,0,18,0,1,0,19,0,54,0,55,0,72,0,54,0,37,0,
+    55,0,35,0,36,0,54,0,36,0,37,0,54,0,36,0,19,0,37,0,99,0,100,0,
+    118,0,99,0,118,0,117,0,117,0,118,0,136,0,117,0,136,0,135,0,116,0,117,0,
+    135,0,98,0,99,0,117,0,98,0,117,0,116,0,97,0,98,0,116,0,81,0,82,0,
+    100,0,81,0,100,0,99,0,80,0,81,0,99,0,80,0,99,0,98,0,63,0,64,0,
+    82,0,63,0,82,0,81,0,62,0,63,0,81,0,62,0,81,0,80,0,79,0,80,0,
+    98,0,79,0,98,0,97,0,61,0,62,0,80,0,61,0,80,0,79,0,145,0,135,0,
+    136,0,145,0,134,0,135,0,145,0,133,0,134,0,116,0,135,0,134,0,115,0,116,0,
+    134,0,115,0,134,0,133,0,114,0,115,0,133,0,145,0,132,0,133,0,145,0,131,0,
+    132,0,145,0,130,0,131,0,114,0,133,0,132,0,113,0,114,0,132,0,113,0,132,0,
+    131,0,97,0,116,0,115,0,96,0,97,0,115,0,96,0,115,0,114,0,95,0,96,0,
+    114,0,95,0,114,0,113,0,78,0,79,0,97,0,60,0,61,0,79,0,60,0,79,0,
+    78,0,78,0,97,0,96,0,77,0,78,0,96,0,77,0,96,0,95,0,59,0,60,0,
+    78,0,59,0,78,0,77,0,45,0,46,0,64,0,45,0,64,0,63,0,27,0,28,0,
+    46,0,27,0,46,0,45,0,26,0,27,0,45,0,9,0,10,0,28,0,9,0,28,0,
+    27,0,8,0,9,0,27,0,8,0,27,0,26,0,44,0,45,0,63,0,26,0,45,0,
+    44,0,44,0,63,0,62,0,25,0,26,0,44,0,43,0,44,0,62,0,25,0,44,0,
+    43,0,43,0,62,0,61,0,0,0,10,0,9,0,0,0,9,0,8,0,0,0,8,0,
+    7,0,0,0,7,0,6,0,7,0,8,0,26,0,7,0,26,0,25,0,6,0,7,0,
+    25,0,6,0,25,0,24,0,0,0,6,0,5,0,0,0,5,0,4,0,4,0,5,0,
+    23,0,5,0,6,0,24,0,5,0,24,0,23,0,42,0,43,0,61,0,42,0,61,0,
+    60,0,24,0,25,0,43,0,24,0,43,0,42,0,23,0,24,0,42,0,23,0,42,0,
+    41,0,41,0,42,0,60,0,41,0,60,0,59,0,145,0,129,0,130,0,145,0,127,0,
+    128,0,145,0,128,0,129,0,109,0,128,0,127,0,109,0,110,0,128,0,110,0,129,0,
+    128,0,111,0,130,0,129,0,110,0,111,0,129,0,92,0,111,0,110,0,91,0,110,0,
+    109,0,91,0,92,0,110,0,73,0,92,0,91,0,73,0,74,0,92,0,112,0,131,0,
+    130,0,112,0,113,0,131,0,111,0,112,0,130,0,94,0,113,0,112,0,94,0,95,0,
+    113,0,76,0,95,0,94,0,76,0,77,0,95,0,92,0,93,0,111,0,74,0,93,0,
+    92,0,93,0,112,0,111,0,74,0,75,0,93,0,93,0,94,0,112,0,75,0,94,0,
+    93,0,75,0,76,0,94,0,55,0,56,0,74,0,55,0,74,0,73,0,56,0,57,0,
+    75,0,56,0,75,0,74,0,37,0,38,0,56,0,37,0,56,0,55,0,38,0,39,0,
+    57,0,38,0,57,0,56,0,40,0,41,0,59,0,40,0,59,0,58,0,58,0,59,0,
+    77,0,58,0,77,0,76,0,39,0,40,0,58,0,39,0,58,0,57,0,57,0,58,0,
+    76,0,57,0,76,0,75,0,0,0,4,0,3,0,0,0,3,0,2,0,0,0,2,0,
+    1,0,2,0,3,0,21,0,1,0,2,0,20,0,2,0,21,0,20,0,1,0,20,0,
+    19,0,19,0,20,0,38,0,19,0,38,0,37,0,3,0,4,0,22,0,3,0,22,0,
+    21,0,4,0,23,0,22,0,21,0,22,0,40,0,22,0,23,0,41,0,22,0,41,0,
+    40,0,21,0,40,0,39,0,20,0,21,0,39,0,20,0,39,0,38,0,0,0,0,0,
+    0,0,255,255,255,255,255,255,88,0,0,0,0,0,0,0,0,0,255,255,255,255,0,128,
+    51,0,0,0,0,0,0,0,0,0,58,150,255,255,0,128,24,0,0,0,0,0,0,0,
+    0,0,58,150,197,105,0,128,13,0,0,0,0,0,184,7,112,15,242,93,197,105,0,128,
+    8,0,0,0,184,7,242,29,112,15,58,86,197,105,232,88,7,0,0,0,242,29,242,29,
+    112,15,58,86,197,105,136,54,0,0,0,130,184,7,242,29,116,44,58,86,197,105,232,88,
+    3,0,0,131,0,0,184,7,120,73,242,93,197,105,0,128,10,0,0,0,116,44,184,7,
+    120,73,242,93,242,29,0,128,7,0,0,131,0,0,242,29,120,73,0,64,197,105,0,128,
+    12,0,0,0,112,15,242,29,120,73,0,64,0,64,0,128,11,0,0,130,0,0,0,64,
+    139,83,58,22,197,105,0,128,14,0,0,129,0,64,0,0,0,0,58,150,197,105,0,128,
+    17,0,0,0,0,64,242,29,0,0,58,150,197,105,136,54,16,0,0,0,0,64,242,29,
+    0,0,126,113,197,105,136,54,16,0,0,131,197,105,242,29,0,0,58,150,197,105,116,44,
+    20,0,0,131,0,64,0,0,116,44,58,150,242,29,0,128,21,0,0,0,0,64,0,0,
+    116,44,0,128,242,29,0,128,20,0,0,0,0,64,184,7,116,44,71,120,242,29,252,98,
+    24,0,0,131,139,83,0,0,139,83,0,128,184,7,0,128,28,0,0,131,126,113,0,0,
+    116,44,58,150,242,29,0,128,23,0,0,0,126,113,184,7,116,44,58,150,242,29,232,88,
+    32,0,0,130,71,120,0,0,139,83,58,150,184,7,0,128,35,0,0,129,0,0,197,105,
+    0,0,58,150,255,255,0,128,36,0,0,0,0,0,197,105,112,15,58,86,71,248,0,128,
+    31,0,0,0,0,0,197,105,112,15,184,71,255,191,0,128,28,0,0,0,242,29,197,105,
+    112,15,184,71,255,191,136,54,37,0,0,131,0,0,197,105,116,44,198,41,255,191,0,128,
+    30,0,0,0,0,0,197,105,116,44,242,29,58,150,0,128,41,0,0,131,0,0,58,150,
+    116,44,198,41,255,191,0,128,45,0,0,131,112,15,255,191,4,29,58,86,71,248,0,128,
+    33,0,0,0,58,22,255,191,4,29,184,71,13,226,252,98,49,0,0,130,112,15,255,191,
+    120,73,58,86,71,248,0,128,35,0,0,0,112,15,255,191,232,88,126,49,13,226,0,128,
+    52,0,0,129,116,44,13,226,120,73,58,86,71,248,0,128,54,0,0,130,0,64,197,105,
+    0,0,58,150,255,255,0,128,44,0,0,0,0,64,197,105,0,0,58,150,13,226,120,73,
+    41,0,0,0,0,64,197,105,0,0,58,150,255,191,4,29,40,0,0,0,0,64,197,105,
+    0,0,116,108,255,191,4,29,57,0,0,131,197,105,197,105,0,0,58,150,255,191,112,15,
+    61,0,0,131,0,64,255,191,112,15,139,147,13,226,120,73,43,0,0,0,0,64,255,191,
+    112,15,126,113,13,226,120,73,65,0,0,130,116,108,255,191,112,15,139,147,13,226,116,44,
+    68,0,0,129,0,64,13,226,116,44,58,150,255,255,0,128,48,0,0,0,0,64,13,226,
+    116,44,0,128,255,255,0,128,47,0,0,0,0,64,13,226,116,44,126,113,71,248,143,112,
+    70,0,0,131,139,83,71,248,232,88,0,128,255,255,0,128,74,0,0,130,197,105,13,226,
+    116,44,58,150,255,255,0,128,50,0,0,0,197,105,13,226,116,44,129,142,71,248,232,88,
+    77,0,0,130,197,105,71,248,139,83,58,150,255,255,0,128,80,0,0,130,0,128,0,0,
+    0,0,255,255,255,255,0,128,71,0,0,0,0,128,0,0,0,0,255,255,58,150,0,128,
+    64,0,0,0,0,128,0,0,112,15,143,240,0,64,0,128,59,0,0,0,129,142,184,7,
+    112,15,197,233,0,64,252,98,58,0,0,0,129,142,184,7,112,15,255,191,0,64,252,98,
+    57,0,0,0,129,142,242,29,112,15,255,191,0,64,120,73,83,0,0,130,129,142,184,7,
+    116,44,255,191,242,29,252,98,86,0,0,130,71,184,242,29,4,29,197,233,0,64,252,98,
+    89,0,0,130,0,128,0,0,120,73,143,240,0,64,0,128,63,0,0,0,0,128,0,0,
+    120,73,139,211,242,29,0,128,62,0,0,0,0,128,0,0,232,88,116,172,184,7,0,128,
+    92,0,0,130,13,162,184,7,120,73,139,211,242,29,0,128,95,0,0,131,129,206,242,29,
+    232,88,143,240,0,64,0,128,99,0,0,129,139,147,0,64,0,0,255,255,58,150,0,128,
+    68,0,0,0,139,147,0,64,0,0,13,226,58,150,136,54,67,0,0,0,139,147,0,64,
+    0,0,255,191,58,150,4,29,101,0,0,131,71,184,0,64,112,15,13,226,58,150,136,54,
+    105,0,0,131,57,214,0,64,116,44,255,255,58,150,0,128,70,0,0,0,57,214,0,64,
+    116,44,255,255,197,105,0,128,109,0,0,131,13,226,197,105,116,44,255,255,58,150,0,128,
+    113,0,0,131,0,128,58,150,0,0,255,255,255,255,0,128,79,0,0,0,184,135,58,150,
+    0,0,71,248,71,248,232,88,76,0,0,0,184,135,58,150,0,0,255,191,71,248,232,88,
+    75,0,0,0,129,142,58,150,0,0,255,191,13,226,136,54,117,0,0,131,184,135,13,226,
+    116,44,255,191,71,248,232,88,121,0,0,130,197,169,58,150,112,15,71,248,13,226,232,88,
+    78,0,0,0,197,169,58,150,112,15,13,226,13,226,136,54,124,0,0,130,197,169,58,150,
+    116,44,71,248,13,226,232,88,127,0,0,131,0,128,58,150,120,73,255,255,255,255,0,128,
+    85,0,0,0,0,128,13,226,120,73,139,211,255,255,0,128,82,0,0,0,0,128,71,248,
+    232,88,116,172,255,255,0,128,131,0,0,130,58,150,13,226,120,73,139,211,71,248,0,128,
+    84,0,0,0,58,150,13,226,120,73,129,206,71,248,252,98,134,0,0,129,13,162,13,226,
+    252,98,139,211,71,248,0,128,136,0,0,130,255,191,58,150,120,73,255,255,13,226,0,128,
+    87,0,0,0,197,233,58,150,139,83,255,255,255,191,0,128,139,0,0,129,255,191,255,191,
+    120,73,143,240,13,226,0,128,141,0,0,130,0,0,0,0,0,128,255,255,255,255,255,255,
+    138,0,0,0,0,0,0,0,0,128,58,150,255,255,255,255,117,0,0,0,0,0,0,0,
+    0,128,58,150,58,150,255,255,102,0,0,0,0,0,184,7,0,128,58,86,58,150,143,240,
+    97,0,0,0,112,15,184,7,0,128,58,86,0,64,251,226,96,0,0,0,112,15,184,7,
+    0,128,58,86,0,64,135,182,95,0,0,0,112,15,242,29,0,128,126,49,0,64,23,167,
+    144,0,0,129,116,44,184,7,0,128,58,86,242,29,135,182,146,0,0,130,58,22,242,29,
+    3,157,184,71,0,64,251,226,149,0,0,130,0,0,0,64,0,128,184,71,58,150,143,240,
+    101,0,0,0,0,0,0,64,0,128,198,41,58,150,139,211,100,0,0,0,0,0,0,64,
+    0,128,198,41,197,105,139,211,152,0,0,131,0,0,197,105,0,128,242,29,58,150,139,211,
+    156,0,0,131,242,29,0,64,119,201,184,71,58,150,143,240,160,0,0,131,0,64,0,0,
+    0,128,58,150,58,150,255,255,110,0,0,0,0,64,0,0,0,128,58,150,242,29,139,211,
+    107,0,0,0,0,64,0,0,0,128,0,128,242,29,139,211,106,0,0,0,139,83,0,0,
+    0,128,0,128,184,7,23,167,164,0,0,130,0,64,184,7,112,143,126,113,242,29,139,211,
+    167,0,0,131,197,105,0,0,0,128,58,150,242,29,139,211,109,0,0,0,197,105,0,0,
+    0,128,58,150,184,7,116,172,171,0,0,130,197,105,184,7,23,167,129,142,242,29,139,211,
+    174,0,0,130,0,64,242,29,135,182,58,150,58,150,255,255,114,0,0,0,0,64,242,29,
+    135,182,139,147,0,64,143,240,113,0,0,0,0,64,242,29,135,182,126,113,0,64,143,240,
+    177,0,0,130,116,108,242,29,139,211,139,147,0,64,143,240,180,0,0,129,0,64,0,64,
+    251,226,58,150,58,150,255,255,116,0,0,0,0,64,0,64,251,226,116,108,58,150,255,255,
+    182,0,0,131,197,105,0,64,143,240,58,150,58,150,255,255,186,0,0,131,0,0,58,150,
+    0,128,58,150,255,255,255,255,127,0,0,0,0,0,58,150,0,128,242,93,71,248,143,240,
+    124,0,0,0,0,0,58,150,0,128,242,93,71,248,135,182,123,0,0,0,0,0,58,150,
+    0,128,0,64,13,226,135,182,122,0,0,0,0,0,58,150,0,128,58,22,255,191,116,172,
+    190,0,0,129,112,15,255,191,0,128,0,64,13,226,135,182,192,0,0,130,116,44,13,226,
+    0,128,242,93,71,248,135,182,195,0,0,131,184,7,58,150,23,167,58,86,13,226,143,240,
+    126,0,0,0,184,7,58,150,23,167,58,86,13,226,139,211,199,0,0,131,242,29,58,150,
+    119,201,58,86,13,226,143,240,203,0,0,130,0,64,58,150,0,128,58,150,255,255,255,255,
+    135,0,0,0,0,64,13,226,0,128,58,150,255,255,139,211,132,0,0,0,0,64,13,226,
+    0,128,0,128,255,255,139,211,131,0,0,0,139,83,71,248,0,128,0,128,255,255,116,172,
+    206,0,0,131,0,64,13,226,3,157,71,120,71,248,139,211,210,0,0,131,126,113,13,226,
+    0,128,58,150,255,255,139,211,134,0,0,0,71,120,71,248,0,128,58,150,255,255,116,172,
+    214,0,0,129,126,113,13,226,23,167,58,150,71,248,139,211,216,0,0,130,0,64,58,150,
+    119,201,58,150,13,226,255,255,137,0,0,0,0,64,58,150,119,201,126,113,13,226,255,255,
+    219,0,0,131,197,105,58,150,139,211,58,150,13,226,255,255,223,0,0,131,0,128,0,0,
+    0,128,255,255,255,255,255,255,156,0,0,0,0,128,0,0,0,128,255,255,197,105,255,255,
+    149,0,0,0,0,128,0,0,0,128,255,255,197,105,135,182,146,0,0,0,0,128,0,0,
+    0,128,139,211,242,29,135,182,143,0,0,0,0,128,0,0,0,128,116,172,184,7,23,167,
+    227,0,0,130,58,150,184,7,0,128,139,211,242,29,135,182,145,0,0,0,13,162,184,7,
+    0,128,139,211,242,29,3,157,230,0,0,130,58,150,184,7,3,157,129,206,242,29,135,182,
+    233,0,0,129,255,191,242,29,0,128,255,255,197,105,135,182,148,0,0,0,255,191,242,29,
+    0,128,143,240,0,64,135,182,235,0,0,130,197,233,0,64,0,128,255,255,197,105,116,172,
+    238,0,0,129,184,135,184,7,23,167,71,248,197,105,255,255,153,0,0,0,184,135,184,7,
+    23,167,255,191,197,105,255,255,152,0,0,0,184,135,184,7,23,167,255,191,242,29,139,211,
+    240,0,0,130,129,142,242,29,119,201,255,191,197,105,255,255,243,0,0,131,197,169,242,29,
+    23,167,71,248,197,105,143,240,155,0,0,0,197,169,242,29,23,167,71,248,197,105,139,211,
+    247,0,0,131,197,169,242,29,119,201,13,226,197,105,143,240,251,0,0,130,0,128,197,105,
+    0,128,255,255,255,255,255,255,164,0,0,0,139,147,197,105,0,128,255,255,255,191,255,255,
+    161,0,0,0,57,214,197,105,0,128,255,255,255,191,139,211,160,0,0,0,13,226,197,105,
+    0,128,255,255,58,150,139,211,254,0,0,131,57,214,58,150,0,128,255,255,255,191,139,211,
+    2,1,0,131,139,147,197,105,119,201,13,226,255,191,255,255,163,0,0,0,139,147,197,105,
+    251,226,255,191,255,191,255,255,6,1,0,131,71,184,197,105,119,201,13,226,255,191,143,240,
+    10,1,0,131,0,128,255,191,0,128,143,240,255,255,143,240,170,0,0,0,0,128,255,191,
+    0,128,143,240,255,255,135,182,169,0,0,0,0,128,13,226,0,128,139,211,255,255,135,182,
+    168,0,0,0,0,128,71,248,0,128,116,172,255,255,23,167,14,1,0,130,13,162,13,226,
+    0,128,139,211,71,248,135,182,17,1,0,131,129,206,255,191,0,128,143,240,13,226,23,167,
+    21,1,0,129,129,142,255,191,3,157,197,233,71,248,143,240,174,0,0,0,129,142,255,191,
+    3,157,255,191,71,248,143,240,173,0,0,0,129,142,13,226,3,157,255,191,71,248,139,211,
+    23,1,0,130,129,142,255,191,135,182,255,191,13,226,143,240,26,1,0,130,71,184,255,191,
+    3,157,197,233,13,226,251,226,29,1,0,130,
+};
+
+const mesh_asset mesh_assets[] = {
+    { "sphere_320_mesh", sphere_320_mesh, 5460 },
+};
+
+#endif
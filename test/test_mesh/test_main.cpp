@@ -0,0 +1,131 @@
+#include <unity.h>
+#include "ray_tracing.h"
+#include "material.h"
+#include "triangle_mesh.h"
+
+// Triangle mesh tests
+//
+// sphere_mesh.h is a small closed sphere written by
+//   python3 tools/obj2mesh.py --sphere 320 --header test/test_mesh/sphere_mesh.h
+// The BVH traversal must find the same closest hit as testing every
+// triangle, and the watertight test must not let a ray leave the closed
+// mesh through an edge or a vertex.
+
+#include "sphere_mesh.h"
+
+const int RAYS = 20000;
+
+triangle_mesh mesh(sphere_320_mesh, make_shared<lambertian>(Color(0.5, 0.5, 0.5)));
+point3 lo, hi, center;
+
+bool brute_force(const ray& r, double& closest, double& edge) {
+    // Closest hit over every triangle (Moller-Trumbore in double precision);
+    // edge is the smallest barycentric coordinate of that hit
+    bool hit_anything = false;
+    closest = 1e30;
+    for (uint32_t k = 0; k < mesh.triangles(); k++) {
+        point3 v0, v1, v2;
+        mesh.triangle(k, v0, v1, v2);
+        double e1[3], e2[3], s[3], d[3], p[3], q[3];
+        for (int a = 0; a < 3; a++) {
+            e1[a] = double(v1[a]) - v0[a];
+            e2[a] = double(v2[a]) - v0[a];
+            s[a] = double(r.orig[a]) - v0[a];
+            d[a] = r.dir[a];
+        }
+        p[0] = d[1] * e2[2] - d[2] * e2[1];
+        p[1] = d[2] * e2[0] - d[0] * e2[2];
+        p[2] = d[0] * e2[1] - d[1] * e2[0];
+        double det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if (det == 0) {
+            continue;
+        }
+        double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) / det;
+        q[0] = s[1] * e1[2] - s[2] * e1[1];
+        q[1] = s[2] * e1[0] - s[0] * e1[2];
+        q[2] = s[0] * e1[1] - s[1] * e1[0];
+        double v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) / det;
+        double t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) / det;
+        double w = 1 - u - v;
+        if (u < 0 || v < 0 || w < 0 || t <= 0.001 || t >= closest) {
+            continue;
+        }
+        closest = t;
+        edge = fmin(fmin(u, v), w);
+        hit_anything = true;
+    }
+    return hit_anything;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_mesh_is_valid() {
+    TEST_ASSERT_TRUE(mesh.valid());
+    TEST_ASSERT_EQUAL_UINT32(288, mesh.triangles());
+    TEST_ASSERT_EQUAL_UINT32(sizeof(sphere_320_mesh), mesh.bytes());
+}
+
+void test_bvh_matches_brute_force() {
+    // Rays from a sphere around the mesh towards random points in its bounds
+    srand(12345);
+    float radius = (hi - lo).length();
+    int hits = 0, grazing = 0;
+    for (int k = 0; k < RAYS; k++) {
+        point3 origin = center + radius * random_unit_vector();
+        point3 target(random_float(lo[0], hi[0]), random_float(lo[1], hi[1]), random_float(lo[2], hi[2]));
+        ray r(origin, target - origin);
+
+        hit_record rec;
+        bool hit = mesh.hit(r, interval(0.001, inf), rec);
+        double closest, edge;
+        bool expected = brute_force(r, closest, edge);
+        if (hit != expected) {
+            // Only a ray through an edge may go either way between the two tests
+            TEST_ASSERT_TRUE_MESSAGE(expected && edge < 1e-5, "BVH and brute force disagree away from an edge");
+            grazing++;
+            continue;
+        }
+        if (hit) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f * float(closest), float(closest), rec.t);
+            hits++;
+        }
+    }
+    TEST_ASSERT_TRUE(hits > RAYS / 2);
+    TEST_ASSERT_TRUE(grazing < 10);
+}
+
+void test_no_misses_from_inside() {
+    // From inside the closed mesh every ray must hit a back face, including
+    // rays aimed straight at the shared vertices
+    srand(54321);
+    for (int k = 0; k < RAYS; k++) {
+        point3 origin = center + 0.5f * random_float() * random_unit_vector();
+        ray r(origin, random_unit_vector());
+        hit_record rec;
+        TEST_ASSERT_TRUE_MESSAGE(mesh.hit(r, interval(0.001, inf), rec), "ray escaped the closed mesh");
+        TEST_ASSERT_FALSE(rec.front_face);
+    }
+
+    for (uint32_t k = 0; k < mesh.triangles(); k++) {
+        point3 v[3];
+        mesh.triangle(k, v[0], v[1], v[2]);
+        for (int corner = 0; corner < 3; corner++) {
+            hit_record rec;
+            TEST_ASSERT_TRUE_MESSAGE(mesh.hit(ray(center, v[corner] - center), interval(0.001, inf), rec),
+                                     "ray through a vertex escaped the closed mesh");
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, rec.t);
+        }
+    }
+}
+
+int main() {
+    mesh.bounds(lo, hi);
+    center = 0.5f * (lo + hi);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_mesh_is_valid);
+    RUN_TEST(test_bvh_matches_brute_force);
+    RUN_TEST(test_no_misses_from_inside);
+    return UNITY_END();
+}
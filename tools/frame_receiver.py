@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""Host side receiver for the frame stream in include/frame_stream.h.
+
+Reads packets from a serial port, a pseudo terminal or a captured dump,
+reassembles the frames and writes them out as PPM or PNG files:
+
+    python3 tools/frame_receiver.py /dev/ttyACM0 --out frames --png
+
+Each finished frame is reported with its encoding, bytes per frame,
+compression ratio and wire throughput.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import termios
+import tty
+import zlib
+
+SYNC = b"\xA5\x5A"
+PACKET_FRAME_BEGIN = 1
+PACKET_TILE = 2
+PACKET_FRAME_END = 3
+ENCODINGS = {0: "raw", 1: "rle", 2: "qoi565"}
+
+
+def crc16(data, crc=0xFFFF):
+    # CRC-16/CCITT-FALSE, same as frame_stream::crc16
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def decode_raw(data, count):
+    return list(struct.unpack_from("<%dH" % count, data))
+
+
+def decode_rle(data, count):
+    out = []
+    i = 0
+    while len(out) < count:
+        control = data[i]
+        i += 1
+        if control >= 128:
+            (value,) = struct.unpack_from("<H", data, i)
+            i += 2
+            out.extend([value] * (control - 126))
+        else:
+            n = control + 1
+            out.extend(struct.unpack_from("<%dH" % n, data, i))
+            i += 2 * n
+    return out[:count]
+
+
+def qoi565_hash(p):
+    return ((p >> 11) * 3 + ((p >> 5) & 0x3F) * 5 + (p & 0x1F) * 7) % 64
+
+
+def decode_qoi565(data, count):
+    index = [0] * 64
+    prev = 0
+    out = []
+    i = 0
+    while len(out) < count:
+        op = data[i]
+        i += 1
+        if op == 0xFE:
+            (p,) = struct.unpack_from("<H", data, i)
+            i += 2
+        elif op >> 6 == 3:
+            out.extend([prev] * ((op & 0x3F) + 1))
+            continue
+        elif op >> 6 == 0:
+            out.append(index[op])
+            prev = index[op]
+            continue
+        else:
+            r, g, b = prev >> 11, (prev >> 5) & 0x3F, prev & 0x1F
+            if op >> 6 == 1:
+                dr = ((op >> 4) & 3) - 2
+                dg = ((op >> 2) & 3) - 2
+                db = (op & 3) - 2
+            else:
+                dg = (op & 0x3F) - 32
+                second = data[i]
+                i += 1
+                dr = dg + (second >> 4) - 8
+                db = dg + (second & 0x0F) - 8
+            p = (((r + dr) & 0x1F) << 11) | (((g + dg) & 0x3F) << 5) | ((b + db) & 0x1F)
+        index[qoi565_hash(p)] = p
+        out.append(p)
+        prev = p
+    return out[:count]
+
+
+DECODERS = {0: decode_raw, 1: decode_rle, 2: decode_qoi565}
+
+
+def rgb565_to_rgb888(p):
+    r, g, b = p >> 11, (p >> 5) & 0x3F, p & 0x1F
+    return (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)
+
+
+def write_ppm(path, width, height, pixels):
+    with open(path, "wb") as f:
+        f.write(b"P6\n%d %d\n255\n" % (width, height))
+        f.write(bytes(c for p in pixels for c in rgb565_to_rgb888(p)))
+
+
+def write_png(path, width, height, pixels):
+    def chunk(kind, body):
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", zlib.crc32(kind + body) & 0xFFFFFFFF)
+
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        for p in pixels[y * width:(y + 1) * width]:
+            raw.extend(rgb565_to_rgb888(p))
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(bytes(raw), 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+class Receiver:
+    def __init__(self, out_dir, png, max_frames):
+        self.out_dir = out_dir
+        self.png = png
+        self.max_frames = max_frames
+        self.buffer = bytearray()
+        self.frame = None
+        self.width = self.height = 0
+        self.saved = 0
+        self.bad_packets = 0
+
+    def feed(self, data):
+        self.buffer.extend(data)
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                del self.buffer[:-1]
+                return
+            del self.buffer[:start]
+            if len(self.buffer) < 8:
+                return
+            kind, encoding, frame_id, length = struct.unpack_from("<BBHH", self.buffer, 2)
+            total = 8 + length + 2
+            if len(self.buffer) < total:
+                return
+            body = bytes(self.buffer[2:8 + length])
+            (crc,) = struct.unpack_from("<H", self.buffer, 8 + length)
+            if crc16(body) != crc:
+                # Skip just the sync bytes and look for the next packet
+                self.bad_packets += 1
+                del self.buffer[:2]
+                continue
+            del self.buffer[:total]
+            self.handle(kind, encoding, frame_id, body[6:])
+
+    def handle(self, kind, encoding, frame_id, payload):
+        if kind == PACKET_FRAME_BEGIN:
+            self.width, self.height = struct.unpack_from("<HH", payload)
+            self.frame = [0] * (self.width * self.height)
+        elif kind == PACKET_TILE and self.frame is not None:
+            x, y, w, h = struct.unpack_from("<HHHH", payload)
+            pixels = DECODERS[encoding](payload[8:], w * h)
+            for row in range(h):
+                offset = (y + row) * self.width + x
+                self.frame[offset:offset + w] = pixels[row * w:(row + 1) * w]
+        elif kind == PACKET_FRAME_END and self.frame is not None:
+            raw, encoded, wire, elapsed_us, dropped = struct.unpack_from("<IIIII", payload)
+            self.save(frame_id, ENCODINGS.get(encoding, str(encoding)), raw, encoded, wire, elapsed_us, dropped)
+            self.frame = None
+
+    def save(self, frame_id, encoding, raw, encoded, wire, elapsed_us, dropped):
+        extension = "png" if self.png else "ppm"
+        path = os.path.join(self.out_dir, "frame_%04d.%s" % (frame_id, extension))
+        (write_png if self.png else write_ppm)(path, self.width, self.height, self.frame)
+        seconds = elapsed_us / 1e6
+        print("%s: %dx%d %-6s raw %d B, encoded %d B (%.2fx), wire %d B, %.1f s, %.1f KB/s, %d dropped tiles, %d bad packets"
+              % (path, self.width, self.height, encoding, raw, encoded, raw / max(encoded, 1), wire,
+                 seconds, wire / 1024.0 / max(seconds, 1e-6), dropped, self.bad_packets))
+        sys.stdout.flush()
+        self.saved += 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial device, pseudo terminal or captured dump")
+    parser.add_argument("--out", default=".", help="directory for the received frames")
+    parser.add_argument("--png", action="store_true", help="write PNG instead of PPM")
+    parser.add_argument("--frames", type=int, default=0, help="stop after this many frames (0 = forever)")
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    fd = os.open(args.port, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd, termios.TCSANOW)
+
+    receiver = Receiver(args.out, args.png, args.frames)
+    try:
+        while not args.frames or receiver.saved < args.frames:
+            data = os.read(fd, 65536)
+            if not data:
+                break
+            receiver.feed(data)
+    except (KeyboardInterrupt, OSError):
+        pass
+    finally:
+        os.close(fd)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""Host side converter from Wavefront OBJ to the mesh format in include/triangle_mesh.h.
+
+Quantizes the positions to 16 bits inside the mesh bounds, builds a binned
+SAH BVH, reorders the triangles into leaf order and writes the blob either
+as a binary file (for the SD card or PSRAM) or as a C header (for flash):
+
+    python3 tools/obj2mesh.py bunny.obj --bin bunny.mesh
+    python3 tools/obj2mesh.py bunny.obj --header include/bunny_mesh.h
+
+Synthetic spheres of about N triangles stand in for models on hand, e.g.
+the meshes of the benchmark:
+
+    python3 tools/obj2mesh.py --sphere 1000 --sphere 10000 --sphere 100000 \\
+        --header include/bench_meshes.h
+
+Every mesh is reported with its size in bytes per triangle.
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+
+MESH_MAGIC = 0x48534D54
+MESH_VERSION = 1
+MESH_INDEX32 = 1
+MESH_STACK_DEPTH = 48  # same as triangle_mesh.h
+HEADER_FORMAT = "<IHHIII3f3fIII"
+NODE_FORMAT = "<3H3HI"
+LEAF_SIZE = 4
+MAX_LEAF_SIZE = 128
+SAH_BINS = 16
+
+
+def load_obj(path):
+    # Read positions and faces, fan-triangulating polygons
+    vertices, triangles = [], []
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if not fields:
+                continue
+            if fields[0] == "v":
+                vertices.append(tuple(float(x) for x in fields[1:4]))
+            elif fields[0] == "f":
+                face = []
+                for field in fields[1:]:
+                    k = int(field.split("/")[0])
+                    face.append(k - 1 if k > 0 else len(vertices) + k)
+                for k in range(1, len(face) - 1):
+                    triangles.append((face[0], face[k], face[k + 1]))
+    return vertices, triangles
+
+
+def make_sphere(target):
+    # UV sphere of unit radius with about target triangles
+    rings = max(2, int(round(math.sqrt(target / 4.0))))
+    segments = 2 * rings
+    vertices = [(0.0, 1.0, 0.0)]
+    for r in range(1, rings):
+        theta = math.pi * r / rings
+        for s in range(segments):
+            phi = 2 * math.pi * s / segments
+            vertices.append((math.sin(theta) * math.cos(phi), math.cos(theta), math.sin(theta) * math.sin(phi)))
+    vertices.append((0.0, -1.0, 0.0))
+    bottom = len(vertices) - 1
+
+    def ring(r, s):
+        return 1 + (r - 1) * segments + s % segments
+
+    triangles = []
+    for s in range(segments):
+        triangles.append((0, ring(1, s + 1), ring(1, s)))
+        triangles.append((bottom, ring(rings - 1, s), ring(rings - 1, s + 1)))
+    for r in range(1, rings - 1):
+        for s in range(segments):
+            a, b = ring(r, s), ring(r, s + 1)
+            c, d = ring(r + 1, s), ring(r + 1, s + 1)
+            triangles.append((a, b, d))
+            triangles.append((a, d, c))
+    return vertices, triangles
+
+
+def quantize(vertices):
+    # Map positions to a 16-bit grid over the bounds
+    lo = [min(v[a] for v in vertices) for a in range(3)]
+    hi = [max(v[a] for v in vertices) for a in range(3)]
+    scale = [max(hi[a] - lo[a], 1e-6) / 65535.0 for a in range(3)]
+    quantized = []
+    for v in vertices:
+        quantized.append(tuple(min(65535, max(0, int(round((v[a] - lo[a]) / scale[a])))) for a in range(3)))
+    return lo, scale, quantized
+
+
+def area(lo, hi):
+    dx, dy, dz = (max(0, hi[a] - lo[a]) for a in range(3))
+    return dx * dy + dy * dz + dz * dx
+
+
+def build_bvh(quantized, triangles, leaf_size):
+    # Build the BVH depth first; returns the nodes and the triangle order
+    boxes, centroids = [], []
+    for tri in triangles:
+        p = [quantized[k] for k in tri]
+        lo = tuple(min(q[a] for q in p) for a in range(3))
+        hi = tuple(max(q[a] for q in p) for a in range(3))
+        boxes.append((lo, hi))
+        centroids.append(tuple(0.5 * (lo[a] + hi[a]) for a in range(3)))
+
+    nodes, order = [], []
+
+    def bounds(items):
+        lo = [min(boxes[t][0][a] for t in items) for a in range(3)]
+        hi = [max(boxes[t][1][a] for t in items) for a in range(3)]
+        return lo, hi
+
+    def split(items, depth):
+        # Binned SAH along the widest centroid axis, median split as the fallback
+        clo = [min(centroids[t][a] for t in items) for a in range(3)]
+        chi = [max(centroids[t][a] for t in items) for a in range(3)]
+        axis = max(range(3), key=lambda a: chi[a] - clo[a])
+        if chi[axis] == clo[axis]:
+            half = len(items) // 2
+            return items[:half], items[half:]
+
+        if depth < MESH_STACK_DEPTH - 8:
+            width = (chi[axis] - clo[axis]) / SAH_BINS
+            bins = [[] for _ in range(SAH_BINS)]
+            for t in items:
+                bins[min(SAH_BINS - 1, int((centroids[t][axis] - clo[axis]) / width))].append(t)
+            bin_bounds = [bounds(b) if b else None for b in bins]
+
+            def sweep(indices):
+                costs, lo, hi, count = [], None, None, 0
+                for k in indices:
+                    if bin_bounds[k]:
+                        blo, bhi = bin_bounds[k]
+                        lo = blo if lo is None else [min(lo[a], blo[a]) for a in range(3)]
+                        hi = bhi if hi is None else [max(hi[a], bhi[a]) for a in range(3)]
+                        count += len(bins[k])
+                    costs.append(count * area(lo, hi) if count else 0)
+                return costs
+
+            left_costs = sweep(range(SAH_BINS - 1))
+            right_costs = sweep(range(SAH_BINS - 1, 0, -1))[::-1]
+            best = min(range(SAH_BINS - 1), key=lambda k: left_costs[k] + right_costs[k])
+            left = [t for k in range(best + 1) for t in bins[k]]
+            right = [t for k in range(best + 1, SAH_BINS) for t in bins[k]]
+            if left and right:
+                return left, right
+
+        items = sorted(items, key=lambda t: centroids[t][axis])
+        half = len(items) // 2
+        return items[:half], items[half:]
+
+    def build(items, depth):
+        if depth >= MESH_STACK_DEPTH:
+            sys.exit("obj2mesh: BVH deeper than %d levels" % MESH_STACK_DEPTH)
+        lo, hi = bounds(items)
+        index = len(nodes)
+        nodes.append(None)
+        if len(items) <= leaf_size:
+            first = len(order)
+            if first >= (1 << 24):
+                sys.exit("obj2mesh: too many triangles")
+            order.extend(items)
+            nodes[index] = (lo, hi, 0x80000000 | ((len(items) - 1) << 24) | first)
+            return
+        left, right = split(items, depth)
+        build(left, depth + 1)
+        right_index = len(nodes)
+        build(right, depth + 1)
+        nodes[index] = (lo, hi, right_index)
+
+    sys.setrecursionlimit(10000)
+    build(list(range(len(triangles))), 0)
+    return nodes, order
+
+
+def pad4(data):
+    return data + b"\0" * (-len(data) % 4)
+
+
+def convert(vertices, triangles, leaf_size=LEAF_SIZE):
+    # Return the mesh blob
+    triangles = [t for t in triangles if len(set(t)) == 3]
+    if not triangles:
+        sys.exit("obj2mesh: no triangles")
+    lo, scale, quantized = quantize(vertices)
+    nodes, order = build_bvh(quantized, triangles, leaf_size)
+
+    flags = MESH_INDEX32 if len(vertices) > 65535 else 0
+    index_format = "<3I" if flags & MESH_INDEX32 else "<3H"
+    vertex_data = pad4(b"".join(struct.pack("<3H", *q) for q in quantized))
+    index_data = pad4(b"".join(struct.pack(index_format, *triangles[t]) for t in order))
+    node_data = b"".join(struct.pack(NODE_FORMAT, *n[0], *n[1], n[2]) for n in nodes)
+
+    vertex_offset = struct.calcsize(HEADER_FORMAT)
+    index_offset = vertex_offset + len(vertex_data)
+    node_offset = index_offset + len(index_data)
+    header = struct.pack(HEADER_FORMAT, MESH_MAGIC, MESH_VERSION, flags, len(vertices), len(triangles),
+                         len(nodes), *lo, *scale, vertex_offset, index_offset, node_offset)
+    return header + vertex_data + index_data + node_data, len(triangles), len(nodes)
+
+
+def write_header(path, meshes):
+    # Write the blobs as PROGMEM arrays, so they stay in flash on Teensy 4
+    guard = os.path.basename(path).upper().replace(".", "_").replace("-", "_")
+    with open(path, "w") as f:
+        f.write("// Generated by tools/obj2mesh.py, do not edit\n")
+        f.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+        f.write('#include "triangle_mesh.h"\n\n')
+        f.write("#ifndef PROGMEM\n#define PROGMEM\n#endif\n\n")
+        for name, blob in meshes:
+            f.write("alignas(4) const uint8_t %s[%d] PROGMEM = {\n" % (name, len(blob)))
+            for k in range(0, len(blob), 24):
+                f.write("    " + ",".join("%d" % b for b in blob[k:k + 24]) + ",\n")
+            f.write("};\n\n")
+        f.write("const mesh_asset mesh_assets[] = {\n")
+        for name, blob in meshes:
+            f.write('    { "%s", %s, %d },\n' % (name, name, len(blob)))
+        f.write("};\n\n#endif\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("obj", nargs="*", help="OBJ files to convert")
+    parser.add_argument("--sphere", type=int, action="append", default=[], help="add a sphere of about N triangles")
+    parser.add_argument("--bin", help="write the (single) mesh to this binary file")
+    parser.add_argument("--header", help="write every mesh to this C header")
+    parser.add_argument("--leaf", type=int, default=LEAF_SIZE,
+                        help="triangles per BVH leaf (larger is smaller and slower, default %d)" % LEAF_SIZE)
+    args = parser.parse_args()
+
+    sources = [(os.path.splitext(os.path.basename(p))[0], lambda p=p: load_obj(p)) for p in args.obj]
+    sources += [("sphere_%d" % n, lambda n=n: make_sphere(n)) for n in args.sphere]
+    if not sources:
+        parser.error("nothing to convert")
+    if not 1 <= args.leaf <= MAX_LEAF_SIZE:
+        parser.error("--leaf must be between 1 and %d" % MAX_LEAF_SIZE)
+    if args.bin and len(sources) != 1:
+        parser.error("--bin takes exactly one mesh")
+
+    meshes = []
+    for name, load in sources:
+        name = "".join(c if c.isalnum() else "_" for c in name) + "_mesh"
+        vertices, triangles = load()
+        blob, triangle_count, node_count = convert(vertices, triangles, args.leaf)
+        meshes.append((name, blob))
+        print("%s: %d vertices, %d triangles, %d nodes, %d bytes, %.1f bytes/triangle"
+              % (name, len(vertices), triangle_count, node_count, len(blob), len(blob) / triangle_count))
+
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(meshes[0][1])
+    if args.header:
+        write_header(args.header, meshes)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,136 @@
+// Host stand-in for the board side of the frame stream.
+//
+// Opens a pseudo terminal, prints the slave path and streams one frame per
+// encoding through frame_stream exactly as camera::render does on the
+// Teensy (one tile per row, pump() between "pixels"):
+//
+//   g++ -std=c++17 -O2 -Iinclude tools/stream_pty_demo.cpp -o stream_pty_demo
+//   ./stream_pty_demo [image.ppm] &
+//   python3 tools/frame_receiver.py /dev/pts/N --frames 3
+//
+// Without an image a synthetic 320x240 scene is used.
+
+#include "frame_stream.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+static uint16_t rgb565(int r, int g, int b) {
+    return uint16_t(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static bool load_ppm(const char* path, int& width, int& height, std::vector<uint16_t>& pixels) {
+    // Read a binary (P6, maxval 255) PPM
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    int maxval = 0;
+    bool ok = fscanf(f, "P6 %d %d %d", &width, &height, &maxval) == 3 && maxval == 255 && fgetc(f) != EOF;
+    if (ok) {
+        pixels.resize(size_t(width) * height);
+        for (auto& p : pixels) {
+            uint8_t rgb[3];
+            if (fread(rgb, 1, 3, f) != 3) {
+                ok = false;
+                break;
+            }
+            p = rgb565(rgb[0], rgb[1], rgb[2]);
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+static void synthetic_scene(int width, int height, std::vector<uint16_t>& pixels) {
+    // Sky gradient, noisy ground and a few flat discs, roughly like the real render
+    pixels.resize(size_t(width) * height);
+    srand(1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float t = float(y) / height;
+            int r = int(255 * (1 - 0.5f * (1 - t)));
+            int g = int(255 * (1 - 0.3f * (1 - t)));
+            int b = 255;
+            if (y > height / 2) {
+                int n = rand() % 24;
+                r = g = b = 110 + n;
+            }
+            for (int s = 0; s < 3; s++) {
+                int cx = width / 4 * (s + 1), cy = height / 2, rad = height / 6;
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) < rad * rad) {
+                    r = 60 * (s + 1) + rand() % 8;
+                    g = 40 + 50 * s;
+                    b = 160 - 50 * s;
+                }
+            }
+            pixels[size_t(y) * width + x] = rgb565(r, g, b);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int width = 320, height = 240;
+    std::vector<uint16_t> image;
+    if (argc > 1) {
+        if (!load_ppm(argv[1], width, height, image)) {
+            fprintf(stderr, "could not read %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        synthetic_scene(width, height, image);
+    }
+
+    // Open the pseudo terminal in raw, non-blocking mode
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        return 1;
+    }
+    termios raw;
+    tcgetattr(master, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(master, TCSANOW, &raw);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    printf("%s\n", ptsname(master));
+    fflush(stdout);
+
+    // Give the receiver time to attach before the first frame
+    sleep(2);
+
+    fd_sink sink(master);
+    frame_stream stream(sink);
+
+    // Nothing renders between tiles here, so let every packet wait for the receiver
+    stream.packet_timeout_us = 10000000;
+    stream.stall_timeout_us = 10000000;
+
+    const frame_encoding encodings[] = { ENCODING_RAW, ENCODING_RLE, ENCODING_QOI565 };
+    const char* names[] = { "raw", "rle", "qoi565" };
+    for (int e = 0; e < 3; e++) {
+        stream.encoding = encodings[e];
+        stream.begin_frame(width, height);
+        for (int y = height - 1; y >= 0; y--) {
+            for (int x = 0; x < width; x++) {
+                stream.pump();
+            }
+            stream.send_tile(0, y, width, 1, &image[size_t(y) * width]);
+        }
+        stream.end_frame();
+        stream.flush(stream.stall_timeout_us);
+
+        const frame_stats& s = stream.last_frame;
+        fprintf(stderr, "%-6s %7u B/frame (%.2fx), wire %7u B, %.1f KB/s, stalled %u us, dropped %u tiles\n",
+                names[e], s.encoded_bytes, s.ratio(), s.wire_bytes, s.bytes_per_second() / 1024.0f,
+                s.stall_us, s.dropped_tiles);
+    }
+
+    // Leave the pty open until the receiver has read everything
+    sleep(1);
+    close(master);
+    return 0;
+}